@@ -63,8 +63,7 @@ gloperate_text::GlyphVertexCloud prepareGlyphSequences(const glm::vec2 origin, s
 	std::vector<gloperate_text::GlyphSequence> sequences;
 
 	gloperate_text::GlyphSequence sequence;
-	std::u32string unicode_string(string.begin(), string.end());
-	sequence.setString(unicode_string);
+	sequence.setString(string);
 
 	// set wordWrap, lineWidth, alignment, lineAnchor, fontFace, fontSize, fontColor
 	sequence.setFromConfig(config);
@@ -100,8 +99,7 @@ gloperate_text::GlyphVertexCloud preparePoint(const glm::vec2 origin, gloperate_
 	std::vector<gloperate_text::GlyphSequence> sequences;
 
 	gloperate_text::GlyphSequence sequence;
-	std::u32string unicode_string(pointText.begin(), pointText.end());
-	sequence.setString(unicode_string);
+	sequence.setString(pointText);
 
 	sequence.setWordWrap(true);
 	sequence.setLineWidth(500.f);
@@ -29,7 +29,7 @@ RectangleDrawable::~RectangleDrawable()
 {
 }
 
-void RectangleDrawable::initialize(const std::vector<glm::vec2> & rectangles)
+void RectangleDrawable::initialize(const std::vector<glm::vec2> & rectangles, const std::vector<glm::vec2> & lines)
 {
 
     m_vao = new globjects::VertexArray;
@@ -46,6 +46,7 @@ void RectangleDrawable::initialize(const std::vector<glm::vec2> & rectangles)
         data.push_back({rectangles[i+1].x, rectangles[i].y});
         data.push_back(rectangles[i]);
     }
+    data.insert(data.end(), lines.begin(), lines.end());
     m_count = data.size();
 
     auto buffer = new globjects::Buffer();
@@ -20,7 +20,8 @@ public:
     RectangleDrawable(const std::string & dataPath);
     ~RectangleDrawable();
 
-    void initialize(const std::vector<glm::vec2> & rectangles);
+    // rectangles and lines are given as pairs of corners / end points
+    void initialize(const std::vector<glm::vec2> & rectangles, const std::vector<glm::vec2> & lines = {});
     void render();
 
 private:
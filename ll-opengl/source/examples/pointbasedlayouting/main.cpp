@@ -25,6 +25,7 @@
 #include <globjects/logging.h>
 #include <globjects/base/File.h>
 
+#include <openll/ExtentCache.h>
 #include <openll/GlyphRenderer.h>
 #include <openll/FontLoader.h>
 #include <openll/Typesetter.h>
@@ -70,9 +71,11 @@ namespace
     std::unique_ptr<gloperate_text::FontFace> g_font;
     std::unique_ptr<PointDrawable> g_pointDrawable;
     std::unique_ptr<RectangleDrawable> g_rectangleDrawable;
+    std::unique_ptr<RectangleDrawable> g_leaderLineDrawable;
     std::unique_ptr<gloperate_text::GlyphRenderer> g_renderer;
     std::unique_ptr<gloperate_text::GlyphVertexCloud> g_cloud;
     std::unique_ptr<ScreenAlignedQuad> g_quad;
+    std::unique_ptr<gloperate_text::ExtentCache> g_extentCache;
     GeoData cities;
 
     struct Algorithm
@@ -83,6 +86,8 @@ namespace
 
     using namespace std::placeholders;
 
+    std::vector<gloperate_text::LeaderLine> g_leaderLines;
+
     std::vector<Algorithm> layoutAlgorithms
     {
         {"Constant",                                 gloperate_text::layout::constant},
@@ -91,6 +96,7 @@ namespace
         {"Discrete Gradient Descent",                std::bind(gloperate_text::layout::discreteGradientDescent, _1, gloperate_text::layout::standard, glm::vec2(0.2f))},
         {"Simulated Annealing",                      std::bind(gloperate_text::layout::simulatedAnnealing,      _1, gloperate_text::layout::standard, glm::vec2(0.f))},
         {"Simulated Annealing with padding",         std::bind(gloperate_text::layout::simulatedAnnealing,      _1, gloperate_text::layout::standard, glm::vec2(0.2f))},
+        {"Force-directed with leader lines",         std::bind(gloperate_text::layout::forceDirected,           _1, std::ref(g_leaderLines), glm::vec2(0.2f), 64u)},
     };
 }
 
@@ -152,10 +158,8 @@ std::vector<gloperate_text::Label> prepareLabels(gloperate_text::FontFace * font
             fontcolor = .8f + priority * 0.02f;
         }
 
-        const std::u32string unicode_string {string.begin(), string.end()};
-
         gloperate_text::GlyphSequence sequence;
-        sequence.setString(unicode_string);
+        sequence.setString(string);
         sequence.setWordWrap(true);
         sequence.setLineWidth(400.f);
         sequence.setAlignment(gloperate_text::Alignment::LeftAligned);
@@ -172,10 +176,12 @@ std::vector<gloperate_text::Label> prepareLabels(gloperate_text::FontFace * font
         transform = glm::scale(transform, glm::vec3(1 / 300.f));
 
         const auto placement = gloperate_text::LabelPlacement{ glm::vec2{ 0.f, 0.f }
-            , gloperate_text::Alignment::LeftAligned, gloperate_text::LineAnchor::Baseline, true };
+            , gloperate_text::Alignment::LeftAligned, gloperate_text::LineAnchor::Baseline, true, 0.f };
 
         sequence.setAdditionalTransform(transform);
         labels.push_back({sequence, glm::vec2(origin), priority, placement});
+        // narrower shapes, i.e., up to two and three lines, as alternatives to the full line width
+        labels.back().lineWidths = { 200.f, 133.f };
     }
     return labels;
 }
@@ -183,12 +189,10 @@ std::vector<gloperate_text::Label> prepareLabels(gloperate_text::FontFace * font
 
 gloperate_text::GlyphSequence prepareHeadline(gloperate_text::FontFace * font, glm::ivec2 viewport, const std::string & name)
 {
-
-    const std::u32string unicode_string {name.begin(), name.end()};
     const auto origin = glm::vec2{-0.9f, 0.9f};
 
     gloperate_text::GlyphSequence sequence;
-    sequence.setString(unicode_string);
+    sequence.setString(name);
     sequence.setWordWrap(false);
     sequence.setLineWidth(800.f);
     sequence.setAlignment(gloperate_text::Alignment::LeftAligned);
@@ -248,6 +252,17 @@ void prepareRectangleDrawable(const std::vector<gloperate_text::Label> & labels,
     rectangleDrawable.initialize(rectangles);
 }
 
+void prepareLeaderLineDrawable(const std::vector<gloperate_text::LeaderLine> & leaderLines, RectangleDrawable& leaderLineDrawable)
+{
+    std::vector<glm::vec2> lines;
+    for (const auto & leaderLine : leaderLines)
+    {
+        lines.push_back(leaderLine.start);
+        lines.push_back(leaderLine.end);
+    }
+    leaderLineDrawable.initialize({}, lines);
+}
+
 void runAndBenchmark(std::vector<gloperate_text::Label> & labels, Algorithm algorithm)
 {
     auto start = std::chrono::steady_clock::now();
@@ -266,7 +281,8 @@ void runAndBenchmark(std::vector<gloperate_text::Label> & labels, Algorithm algo
         << "  Upper Right:           " << positions[gloperate_text::RelativeLabelPosition::UpperRight] << std::endl
         << "  Upper Left:            " << positions[gloperate_text::RelativeLabelPosition::UpperLeft]  << std::endl
         << "  Lower Left:            " << positions[gloperate_text::RelativeLabelPosition::LowerLeft]  << std::endl
-        << "  Lower Right:           " << positions[gloperate_text::RelativeLabelPosition::LowerRight] << std::endl;
+        << "  Lower Right:           " << positions[gloperate_text::RelativeLabelPosition::LowerRight] << std::endl
+        << "Extent cache hits:       " << g_extentCache->hits() << "/" << g_extentCache->hits() + g_extentCache->misses() << std::endl;
     std::cout << std::endl;
 }
 
@@ -280,8 +296,11 @@ void initialize()
     g_font = std::unique_ptr<gloperate_text::FontFace>(loader.load(dataPath + "/fonts/opensansr36/opensansr36.fnt"));
     g_pointDrawable = std::unique_ptr<PointDrawable>(new PointDrawable(dataPath));
     g_rectangleDrawable = std::unique_ptr<RectangleDrawable>(new RectangleDrawable(dataPath));
+    g_leaderLineDrawable = std::unique_ptr<RectangleDrawable>(new RectangleDrawable(dataPath));
     g_renderer = std::unique_ptr<gloperate_text::GlyphRenderer>(new gloperate_text::GlyphRenderer);
     g_cloud = std::unique_ptr<gloperate_text::GlyphVertexCloud>(new gloperate_text::GlyphVertexCloud);
+    g_extentCache = std::unique_ptr<gloperate_text::ExtentCache>(new gloperate_text::ExtentCache);
+    gloperate_text::Typesetter::setExtentCache(g_extentCache.get());
 
     // parameters specify which columns contain data to be loaded
     auto csvValid = cities.loadCSV(dataPath + "/geodata/cities.csv", 1, 2, 3, 4);
@@ -310,6 +329,7 @@ void initialize()
 
 void deinitialize()
 {
+    gloperate_text::Typesetter::setExtentCache(nullptr);
 
     globjects::detachAllObjects();
 }
@@ -344,12 +364,14 @@ void draw()
             g_quad->setTextureArea(texCoords.first, texCoords.second);
         }
         auto labels = prepareLabels(g_font.get(), g_size);
+        g_leaderLines.clear();
         runAndBenchmark(labels, layoutAlgorithms[g_algorithmID]);
         auto sequences = getSequences(labels);
         sequences.push_back(prepareHeadline(g_font.get(), g_size, layoutAlgorithms[g_algorithmID].name));
         g_cloud->updateWithSequences(sequences, true);
         preparePointDrawable(labels, *g_pointDrawable);
         prepareRectangleDrawable(labels, *g_rectangleDrawable);
+        prepareLeaderLineDrawable(g_leaderLines, *g_leaderLineDrawable);
     }
 
     glDepthMask(GL_FALSE);
@@ -362,6 +384,7 @@ void draw()
         g_quad->render();
     }
     g_pointDrawable->render();
+    g_leaderLineDrawable->render();
     if (g_frames_visible)
     {
         g_rectangleDrawable->render();
@@ -103,11 +103,10 @@ std::vector<gloperate_text::GlyphSequence> prepareSequences(
     for (int renderSize = 5; renderSize < 30; ++renderSize)
     {
         const auto string = std::string{"Example (font "} + std::to_string(size) + ", size " + std::to_string(renderSize) + ")";
-        const std::u32string unicode_string {string.begin(), string.end()};
         const auto origin = glm::vec2{x_coord, y};
 
         gloperate_text::GlyphSequence sequence;
-        sequence.setString(unicode_string);
+        sequence.setString(string);
         sequence.setWordWrap(true);
         sequence.setLineWidth(400.f);
         sequence.setAlignment(gloperate_text::Alignment::LeftAligned);
@@ -74,8 +74,7 @@ std::vector<gloperate_text::GlyphSequence> prepareGlyphSequences(std::string str
 
     // font->setLinespace(1.25f);
     gloperate_text::GlyphSequence sequence;
-    std::u32string unicode_string(string.begin(), string.end());
-    sequence.setString(unicode_string);
+    sequence.setString(string);
     sequence.setWordWrap(true);
     sequence.setLineWidth(500.f);
     sequence.setAlignment(gloperate_text::Alignment::Centered);
@@ -0,0 +1,214 @@
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <openll/Alignment.h>
+#include <openll/FontFace.h>
+#include <openll/FontLoader.h>
+#include <openll/Glyph.h>
+#include <openll/GlyphSequence.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/LineAnchor.h>
+#include <openll/Typesetter.h>
+
+
+#include "datapath.inl"
+
+
+namespace
+{
+    const auto numLabels = 10000;
+    const auto numRuns = 20;
+
+    // short labels of one to three words, as common for annotations of points of interest
+    std::vector<std::u32string> createLabels()
+    {
+        std::mt19937 random(0);
+        std::vector<std::u32string> labels(numLabels);
+
+        for (auto & label : labels)
+        {
+            const auto numWords = 1 + random() % 3;
+            for (auto w = 0u; w < numWords; ++w)
+            {
+                if (w > 0)
+                    label += U' ';
+
+                label += static_cast<char32_t>('A' + random() % 26);
+                const auto length = 2 + random() % 8;
+                for (auto c = 0u; c < length; ++c)
+                    label += static_cast<char32_t>('a' + random() % 26);
+            }
+        }
+        return labels;
+    }
+
+    // the font's glyphs, all advanced by the widest advance and without kerning, so that the
+    // face is of fixed pitch
+    void createFixedPitchFace(const gloperate_text::FontFace & font, gloperate_text::FontFace & face)
+    {
+        face.setAscent(font.ascent());
+        face.setDescent(font.descent());
+        face.setLinegap(font.linegap());
+        face.setBase(font.base());
+        face.setGlyphTextureExtent(font.glyphTextureExtent());
+        face.setGlyphTexturePadding(font.glyphTexturePadding());
+
+        auto pitch = 0.f;
+        for (const auto index : font.glyphs())
+            pitch = std::max(pitch, font.glyph(index).advance());
+
+        for (const auto index : font.glyphs())
+        {
+            const auto & glyph = font.glyph(index);
+
+            gloperate_text::Glyph fixed;
+            fixed.setIndex(index);
+            fixed.setSubTextureOrigin(glyph.subTextureOrigin());
+            fixed.setSubTextureExtent(glyph.subTextureExtent());
+            fixed.setBearing(glyph.bearing());
+            fixed.setExtent(glyph.extent());
+            fixed.setAdvance(pitch);
+            face.addGlyph(fixed);
+        }
+        face.detectFixedAdvance();
+    }
+
+    // the best of all runs in nanoseconds per label
+    template <typename Function>
+    double measure(const Function & function)
+    {
+        auto best = std::chrono::steady_clock::duration::max();
+        for (auto run = 0; run < numRuns; ++run)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min(best, std::chrono::steady_clock::now() - start);
+        }
+        return std::chrono::duration<double, std::nano>(best).count() / numLabels;
+    }
+}
+
+
+int main(int /*argc*/, char * /*argv*/[])
+{
+    const auto dataPath = common::retrieveDataPath("openll", "dataPath");
+
+    gloperate_text::FontLoader loader;
+    const auto font = loader.load(dataPath + "/fonts/opensansr36/opensansr36.fnt", true);
+    if (!font)
+    {
+        std::cerr << "Font not found in " << dataPath << std::endl;
+        return 1;
+    }
+
+    const auto labels = createLabels();
+
+    std::vector<gloperate_text::GlyphSequence> sequences(labels.size());
+    for (size_t i = 0; i < labels.size(); ++i)
+    {
+        sequences[i].setString(labels[i]);
+        sequences[i].setFontFace(font);
+        sequences[i].setFontSize(16.f);
+        sequences[i].setLineWidth(96.f);
+    }
+
+    // glyphs are resolved once, so that only typesetting is measured
+    auto numGlyphs = size_t(0);
+    for (const auto & sequence : sequences)
+        numGlyphs += sequence.depictableSize();
+
+    gloperate_text::GlyphVertexCloud::Vertices vertices(numGlyphs);
+
+    std::cout << numLabels << " labels, " << numGlyphs << " glyphs; best of " << numRuns << " runs" << std::endl
+        << std::endl << "wrap  alignment  anchor    typeset [ns/label]  extent [ns/label]" << std::endl;
+
+    const std::pair<gloperate_text::Alignment, const char *> alignments[] = {
+        { gloperate_text::Alignment::LeftAligned, "left     " },
+        { gloperate_text::Alignment::Centered, "centered " },
+        { gloperate_text::Alignment::RightAligned, "right    " } };
+
+    const std::pair<gloperate_text::LineAnchor, const char *> anchors[] = {
+        { gloperate_text::LineAnchor::Baseline, "baseline" },
+        { gloperate_text::LineAnchor::Center, "center  " } };
+
+    const auto measureTypeset = [&]()
+    {
+        return measure([&]()
+        {
+            auto vertex = vertices.data();
+            for (const auto & sequence : sequences)
+            {
+                gloperate_text::Typesetter::typeset(sequence, vertex);
+                vertex += sequence.depictableSize();
+            }
+        });
+    };
+
+    auto width = 0.f;
+    const auto measureExtent = [&]()
+    {
+        return measure([&]()
+        {
+            for (const auto & sequence : sequences)
+                width += gloperate_text::Typesetter::extent(sequence).x;
+        });
+    };
+
+    for (const auto wordWrap : { false, true })
+    {
+        for (const auto & alignment : alignments)
+        {
+            for (const auto & anchor : anchors)
+            {
+                for (auto & sequence : sequences)
+                {
+                    sequence.setWordWrap(wordWrap);
+                    sequence.setAlignment(alignment.first);
+                    sequence.setLineAnchor(anchor.first);
+                }
+
+                const auto typeset = measureTypeset();
+                const auto extent = measureExtent();
+
+                std::cout << (wordWrap ? "on    " : "off   ") << alignment.second << "  " << anchor.second
+                    << std::fixed << std::setprecision(1) << std::setw(20) << typeset << std::setw(19) << extent << std::endl;
+            }
+        }
+    }
+
+    // fixed pitch faces are typeset without per glyph lookups, which a single kerning pair disables
+    gloperate_text::FontFace fixedPitch;
+    createFixedPitchFace(*font, fixedPitch);
+
+    gloperate_text::FontFace varyingPitch;
+    createFixedPitchFace(*font, varyingPitch);
+    varyingPitch.setKerning('a', 'b', 0.f);
+
+    std::cout << std::endl << "pitch (wrap on, centered, center)  typeset [ns/label]  extent [ns/label]" << std::endl;
+
+    for (const auto face : { &fixedPitch, &varyingPitch })
+    {
+        for (auto & sequence : sequences)
+        {
+            sequence.setFontFace(face);
+            sequence.setWordWrap(true);
+            sequence.setAlignment(gloperate_text::Alignment::Centered);
+            sequence.setLineAnchor(gloperate_text::LineAnchor::Center);
+        }
+
+        const auto typeset = measureTypeset();
+        const auto extent = measureExtent();
+
+        std::cout << (face->fixedAdvance() > 0.f ? "fixed                             " : "varying                           ")
+            << std::fixed << std::setprecision(1) << std::setw(19) << typeset << std::setw(19) << extent << std::endl;
+    }
+
+    delete font;
+    return 0;
+}
@@ -0,0 +1,94 @@
+
+#pragma once
+
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/openll_api.h>
+
+
+namespace gloperate_text
+{
+
+
+/**
+*  @brief
+*    Cumulative arc lengths of a polyline for parameterizing it by
+*    arc length. Lookups of a position or tangent at a given arc
+*    length use a binary search over the segments, i.e., O(log n);
+*    lookups of ascending arc lengths may instead search from the
+*    previous segment in amortized O(1).
+*
+*    Consecutive duplicate points are removed on construction, so
+*    that every segment has a well defined direction.
+*/
+class OPENLL_API ArcLengthTable
+{
+public:
+    ArcLengthTable();
+    ArcLengthTable(const std::vector<glm::vec2> & polyline);
+    virtual ~ArcLengthTable();
+
+    /**
+    *  @brief
+    *    Table of a piecewise cubic Bezier curve, given by its control
+    *    points (3k + 1 for k pieces, adjacent pieces share an end
+    *    point), each piece sampled by the given number of segments.
+    */
+    static ArcLengthTable cubicBezier(
+        const std::vector<glm::vec2> & controlPoints
+    ,   size_t subdivisions = 16);
+
+    const std::vector<glm::vec2> & points() const;
+
+    /**
+    *  @brief
+    *    The length of the polyline, i.e., the largest valid arc length.
+    */
+    float length() const;
+
+    /**
+    *  @brief
+    *    Index of the segment (from points()[index] to points()[index + 1])
+    *    that contains the given arc length (clamped to the polyline).
+    */
+    size_t segment(float arcLength) const;
+
+    /**
+    *  @brief
+    *    Index of the segment that contains the given arc length as
+    *    above, searched from the given segment, e.g., the one of the
+    *    previous lookup.
+    */
+    size_t segment(float arcLength, size_t hint) const;
+
+    glm::vec2 position(float arcLength) const;
+
+    /**
+    *  @brief
+    *    The position at the given arc length on the line through the
+    *    given segment, i.e., extrapolated beyond the polyline's ends.
+    */
+    glm::vec2 position(float arcLength, size_t segment) const;
+
+    /**
+    *  @brief
+    *    The normalized direction of the segment that contains the
+    *    given arc length.
+    */
+    glm::vec2 tangent(float arcLength) const;
+
+    /**
+    *  @brief
+    *    The normalized direction of the given segment.
+    */
+    glm::vec2 segmentTangent(size_t segment) const;
+
+protected:
+    std::vector<glm::vec2> m_points;
+    std::vector<float> m_lengths; // cumulative, m_lengths[i] is the arc length at m_points[i]
+};
+
+
+} // namespace gloperate_text
@@ -0,0 +1,102 @@
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <glm/vec2.hpp>
+
+#include <openll/openll_api.h>
+
+
+namespace gloperate_text
+{
+
+
+class FontFace;
+
+
+/**
+*  @brief
+*    Bounded, thread-safe memoization of font face space extents of
+*    typeset strings, keyed by string, font face, and wrap width (in
+*    font face units). Font size and transforms are applied by the
+*    caller, so that scaled or moved copies of a string share an entry.
+*    When full, the least recently used entry is evicted.
+*
+*    Entries are not invalidated when a font face's glyphs or kerning
+*    are modified or the font face is destroyed; clear() the cache in
+*    that case.
+*/
+class OPENLL_API ExtentCache
+{
+public:
+    ExtentCache(size_t capacity = 4096);
+    virtual ~ExtentCache();
+
+    /**
+    *  @brief
+    *    Looks up the extent of a string; a negative line width denotes
+    *    typesetting without word wrap.
+    *
+    *  @return
+    *    true if the extent was cached
+    */
+    bool find(const std::u32string & string, const FontFace * fontFace, float lineWidth, glm::vec2 & extent);
+
+    void insert(const std::u32string & string, const FontFace * fontFace, float lineWidth, const glm::vec2 & extent);
+
+    void clear();
+
+    size_t capacity() const;
+    size_t size() const;
+
+    size_t hits() const;
+    size_t misses() const;
+
+protected:
+    // a string view with its precomputed hash; indexed keys refer to the string of their entry
+    struct Key
+    {
+        const char32_t * string;
+        size_t length;
+        const FontFace * fontFace;
+        float lineWidth;
+        size_t hash;
+
+        bool operator==(const Key & other) const;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key & key) const;
+    };
+
+    struct Entry
+    {
+        std::u32string string;
+        Key key;
+        glm::vec2 extent;
+    };
+
+    using Entries = std::list<Entry>; // most recently used first
+
+    static Key key(const std::u32string & string, const FontFace * fontFace, float lineWidth);
+
+protected:
+    const size_t m_capacity;
+
+    mutable std::mutex m_mutex;
+    Entries m_entries;
+    std::unordered_map<Key, Entries::iterator, KeyHash> m_index;
+
+    std::atomic<size_t> m_hits;
+    std::atomic<size_t> m_misses;
+};
+
+
+} // namespace gloperate_text
@@ -408,9 +408,55 @@ public:
     */
     void setKerning(GlyphIndex index, GlyphIndex subsequentIndex, float kerning);
 
+    /**
+    * @brief
+    *   The advance shared by all glyphs of a fixed-pitch font face
+    *   without kerning, which allows for typesetting without per glyph
+    *   advance and kerning lookups (see GlyphSequence::fixedPitch).
+    *
+    * @return
+    *   The shared advance in pt, or 0 if the glyphs' advances differ,
+    *   kerning is available, or detectFixedAdvance was not called.
+    */
+    float fixedAdvance() const;
+
+    /**
+    * @brief
+    *   Detects whether all glyphs share their advance and have no kerning
+    *   (done by the FontLoader after loading). Adding a glyph with another
+    *   advance or kerning afterwards resets the fixed advance; modifying
+    *   glyphs directly and empty glyphs added by glyph() do not.
+    */
+    void detectFixedAdvance();
+
+    /**
+    * @brief
+    *   A glyph's quad as typeset at the origin, i.e., its padded bearing
+    *   and extent in pt and its sub texture rectangle.
+    */
+    struct AsciiQuad
+    {
+        glm::vec4 rect;   // lower left (xy) and extent (zw) in pt
+        glm::vec4 uvRect; // lower left (xy) and upper right (zw) of the sub texture
+        bool depictable;
+    };
+
+    /**
+    * @brief
+    *   The quads of all glyphs with ASCII indices, which allows fixed-pitch
+    *   typesetting without per glyph lookups. They are updated when glyphs
+    *   are added or the padding is changed, and by detectFixedAdvance.
+    *
+    * @return
+    *   128 quads indexed by glyph index, not depictable if not added
+    */
+    const AsciiQuad * asciiQuads() const;
+
 
 protected:
 
+    void updateAsciiQuad(GlyphIndex index);
+
     float m_base;
     float m_ascent;
     float m_descent;
@@ -422,6 +468,10 @@ protected:
     globjects::ref_ptr<globjects::Texture> m_glyphTexture;
 
     std::unordered_map<GlyphIndex, Glyph> m_glyphs;
+    Glyph * m_asciiGlyphs[128]; // direct lookup of glyphs with ASCII indices, null if not added
+
+    float m_fixedAdvance;
+    AsciiQuad m_asciiQuads[128];
 };
 
 
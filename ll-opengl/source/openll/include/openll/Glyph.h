@@ -246,6 +246,12 @@ public:
     */
     void setKerning(GlyphIndex subsequentIndex, float kerning);
 
+    /**
+    *  @brief
+    *    Check if kerning data w.r.t. any subsequent glyph is available.
+    */
+    bool hasKerning() const;
+
 protected:
 
     GlyphIndex m_index;
@@ -27,6 +27,22 @@ class Glyph;
 
 class OPENLL_API GlyphSequence
 {
+public:
+    // a character's glyph, looked up from the font face, and its kerning w.r.t. the preceding character
+    struct ResolvedGlyph
+    {
+        const Glyph * glyph;
+        float kerning; // 0 for the first character
+    };
+
+    // characters [begin, oldEnd) of the string before the edits are now [begin, newEnd)
+    struct Edit
+    {
+        size_t begin;
+        size_t oldEnd;
+        size_t newEnd;
+    };
+
 public:
     GlyphSequence();
     virtual ~GlyphSequence();
@@ -37,6 +53,47 @@ public:
     const std::u32string & string() const;
     void setString(const std::u32string & string);
 
+    // decodes UTF-8 into the string's storage; each invalid or truncated sequence is replaced
+    // by U+FFFD. Only runs of ASCII are widened in blocks (where SSE2 is available): multi-byte
+    // sequences are validated and decoded by scalar code, one sequence at a time
+    void setString(const std::string & utf8);
+    void setString(const char * utf8, size_t length);
+
+    // edits of the string that keep resolved glyphs of unchanged characters and are recorded,
+    // e.g., for re-typesetting only the affected lines (see Typesetter::retypeset)
+    void insert(size_t position, const std::u32string & string);
+    void erase(size_t position, size_t count);
+    void append(const std::u32string & string);
+
+    // the range of the string changed since the last resetEdit(), with all edits merged into
+    // one; setString changes the whole string, other settings (e.g., font face) are not recorded
+    bool edited() const;
+    const Edit & edit() const;
+    void resetEdit();
+
+    // resolved glyphs of the string, built on first use and rebuilt after the string or the
+    // font face is changed (but not when glyphs or kerning of the font face are modified)
+    const std::vector<ResolvedGlyph> & glyphRun() const;
+
+    // the advance of all resolved glyphs (line feeds of zero advance aside) if the font face is
+    // of fixed pitch without kerning (see FontFace::fixedAdvance), 0 otherwise; such sequences
+    // are typeset without per glyph advance and kerning lookups
+    float fixedPitch() const;
+
+    // prefix sums of the resolved glyphs' advances including kerning, i.e., element i is the
+    // pen position after the first i glyphs typeset as a single line (size() + 1 elements;
+    // column pens with fixed pitch, see Typesetter::columnPen); built on first use and rebuilt
+    // with the glyph run
+    const std::vector<float> & prefixAdvances() const;
+
+    // resolves the glyphs of a string as glyphRun() does, yet without adding glyphs missing in
+    // the font face (these resolve to an empty glyph), so that the font face may be shared by
+    // concurrent resolution; returns the fixed pitch (see fixedPitch)
+    static float resolve(
+        const FontFace & fontFace
+    ,   const std::u32string & string
+    ,   std::vector<ResolvedGlyph> & glyphRun);
+
     const std::vector<char32_t> & chars(
         std::vector<char32_t> & allChars) const;
     const std::vector<char32_t> & depictableChars(
@@ -76,10 +133,16 @@ public:
 
 protected:
     void computeTransform() const;
+    void resolveGlyphs() const;
+    void spliceGlyphs(size_t position, size_t erased, size_t inserted);
+    void recordEdit(size_t position, size_t erased, size_t inserted);
 
 protected:
     std::u32string m_string;
 
+    bool m_edited;
+    Edit m_edit;
+
     bool m_wordWrap;
     float m_lineWidth;
 
@@ -94,6 +157,14 @@ protected:
     glm::mat4 m_additionalTransform;
     mutable bool m_transformValid;
     mutable glm::mat4 m_transform;
+
+    mutable bool m_glyphRunValid;
+    mutable std::vector<ResolvedGlyph> m_glyphRun;
+    mutable size_t m_depictableSize;
+    mutable float m_fixedPitch;
+
+    mutable bool m_prefixAdvancesValid;
+    mutable std::vector<float> m_prefixAdvances;
 };
 
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include <glm/vec2.hpp>
@@ -11,7 +12,9 @@
 #include <globjects/base/ref_ptr.h>
 #include <globjects/Texture.h>
 
+#include <openll/Alignment.h>
 #include <openll/Drawable.h>
+#include <openll/HitTestIndex.h>
 
 #include <openll/openll_api.h>
 
@@ -58,14 +61,66 @@ public:
     void update(const Vertices & vertices);
     void updateWithSequences(const std::vector<GlyphSequence>& sequences, bool optimized);
 
+    // if enabled, updateWithSequences keeps the glyphs typeset in font face space and, for
+    // sequences whose string, font face, word wrap, line width, and alignment did not change
+    // since the previous update, only reapplies line anchor and transform (disabled by default)
+    bool fontSpaceCaching() const;
+    void setFontSpaceCaching(bool enable);
+
+    // if enabled, updateWithSequences typesets large batches of sequences concurrently, each
+    // into its own range of vertices (disabled by default); the sequences' font faces must not
+    // be modified by other threads meanwhile
+    bool parallelTypesetting() const;
+    void setParallelTypesetting(bool enable);
+
+    // if enabled, updateWithSequences maintains a spatial index of the typeset glyphs for hit
+    // testing, in which only sequences whose glyphs moved are indexed anew (disabled by default)
+    bool hitTesting() const;
+    void setHitTesting(bool enable);
+    const HitTestIndex & hitTestIndex() const;
+
     void optimize(const std::vector<GlyphSequence> & sequences);
 
+protected:
+    // the glyphs of a sequence in m_fontSpaceVertices and the settings they depend on
+    struct FontSpaceLayout
+    {
+        std::u32string string;
+        const FontFace * fontFace;
+        bool wordWrap;
+        float lineWidth;
+        Alignment alignment;
+        size_t begin;
+
+        bool matches(const GlyphSequence & sequence) const;
+    };
+
 protected:
     static gloperate_text::Drawable * createDrawable();
 
+    void typesetWithFontSpaceCache(
+        const std::vector<GlyphSequence> & sequences
+    ,   const std::vector<size_t> & offsets
+    ,   size_t numWorkers);
+
 protected:
     Vertices m_vertices;
 
+    bool m_fontSpaceCaching;
+    Vertices m_fontSpaceVertices;
+    std::vector<FontSpaceLayout> m_fontSpaceLayouts;
+
+    bool m_parallelTypesetting;
+
+    bool m_hitTesting;
+    HitTestIndex m_hitTestIndex;
+
+    // buffers reused by updateWithSequences and optimize
+    std::vector<size_t> m_offsets;
+    std::vector<char32_t> m_optimizeChars;
+    std::vector<size_t> m_optimizePermutation;
+    Vertices m_optimizedVertices;
+
     globjects::ref_ptr<gloperate_text::Drawable> m_drawable;
     globjects::ref_ptr<globjects::Texture> m_texture;
 };
@@ -0,0 +1,157 @@
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/openll_api.h>
+
+
+namespace gloperate_text
+{
+
+
+class GlyphSequence;
+class GlyphVertexCloud;
+
+
+/**
+*  @brief
+*    Spatial index over the glyph quads of typeset sequences for hit
+*    testing, e.g., picking the label or character under the mouse.
+*
+*    A bounding volume hierarchy over the sequences' bounds refers to one
+*    hierarchy over the glyph quads of each sequence, so that point and
+*    rectangle queries take O(log n). Queries are in the xy plane of the
+*    vertices, i.e., after line anchor and transform are applied; a mouse
+*    position has to be unprojected accordingly.
+*/
+class OPENLL_API HitTestIndex
+{
+public:
+    struct Hit
+    {
+        size_t sequence; // index of the sequence
+        size_t index;    // index of the character in the sequence's string
+    };
+
+public:
+    HitTestIndex();
+    virtual ~HitTestIndex();
+
+    /**
+    *  @brief
+    *    Indexes the glyphs of the sequences, typeset in order into the
+    *    cloud's consecutive vertices (as by
+    *    GlyphVertexCloud::updateWithSequences).
+    */
+    void build(
+        const std::vector<GlyphSequence> & sequences
+    ,   const GlyphVertexCloud & cloud);
+
+    /**
+    *  @brief
+    *    Indexes anew only the glyphs of sequences whose quads changed since
+    *    the previous build or update and refits the sequences' bounds. The
+    *    index is built anew if the number of sequences or of any sequence's
+    *    depictable glyphs changed.
+    *
+    *    Refitting keeps the hierarchy over the sequences, which may loosen
+    *    when many sequences move far; build() it again in that case.
+    */
+    void update(
+        const std::vector<GlyphSequence> & sequences
+    ,   const GlyphVertexCloud & cloud);
+
+    /**
+    *  @brief
+    *    The number of indexed sequences.
+    */
+    size_t size() const;
+
+    /**
+    *  @brief
+    *    The lower left and upper right of the sequence's glyph quads; the
+    *    lower left exceeds the upper right if none of its glyphs are
+    *    depictable.
+    */
+    std::pair<glm::vec2, glm::vec2> bounds(size_t sequence) const;
+
+    /**
+    *  @brief
+    *    The glyphs whose quads contain the point or intersect the rectangle
+    *    [lowerLeft, upperRight], in no particular order; hits is cleared
+    *    first.
+    */
+    void glyphsAt(const glm::vec2 & point, std::vector<Hit> & hits) const;
+    void glyphsWithin(
+        const glm::vec2 & lowerLeft
+    ,   const glm::vec2 & upperRight
+    ,   std::vector<Hit> & hits) const;
+
+    /**
+    *  @brief
+    *    The sequences whose bounds contain the point or intersect the
+    *    rectangle [lowerLeft, upperRight], in no particular order;
+    *    sequences is cleared first.
+    */
+    void sequencesAt(const glm::vec2 & point, std::vector<size_t> & sequences) const;
+    void sequencesWithin(
+        const glm::vec2 & lowerLeft
+    ,   const glm::vec2 & upperRight
+    ,   std::vector<size_t> & sequences) const;
+
+protected:
+    // a glyph quad in the xy plane, spanned by tangent and bitangent from its origin
+    struct Item
+    {
+        glm::vec2 origin;
+        glm::vec2 tangent;
+        glm::vec2 bitangent;
+        std::uint32_t vertex; // index of the vertex
+        std::uint32_t index;  // index of the character in the sequence's string
+    };
+
+    // a leaf refers to count elements starting at first; an inner node (count of 0) to its
+    // children at first and first + 1
+    struct Node
+    {
+        glm::vec2 lowerLeft;
+        glm::vec2 upperRight;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+protected:
+    // fills the sequence's items from its vertices and builds its hierarchy
+    void indexSequence(
+        const GlyphSequence & sequence
+    ,   size_t index
+    ,   const GlyphVertexCloud & cloud);
+
+    // updates the bounds of the hierarchy over all sequences, bottom up
+    void refit();
+
+    template <typename Callback>
+    void visitSequences(
+        const glm::vec2 & lowerLeft
+    ,   const glm::vec2 & upperRight
+    ,   Callback callback) const;
+
+protected:
+    // the items of sequence i are [m_offsets[i], m_offsets[i + 1]), the nodes of its hierarchy
+    // start at twice its first item
+    std::vector<size_t> m_offsets;
+    std::vector<Item> m_items;
+    std::vector<Node> m_glyphNodes;
+
+    // the hierarchy over all sequences with depictable glyphs
+    std::vector<std::uint32_t> m_sequences;
+    std::vector<Node> m_sequenceNodes;
+};
+
+
+} // namespace gloperate_text
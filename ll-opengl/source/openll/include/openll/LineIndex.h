@@ -0,0 +1,74 @@
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/LineMetrics.h>
+
+#include <openll/openll_api.h>
+
+
+namespace gloperate_text
+{
+
+
+class GlyphSequence;
+
+
+/**
+*  @brief
+*    The lines of a sequence, measured once, for typesetting only the
+*    lines within a visible window of a long text (see
+*    Typesetter::typeset with line range), e.g., when scrolling.
+*
+*    The index is not updated when the sequence is modified; build() it
+*    again in that case.
+*/
+class OPENLL_API LineIndex
+{
+public:
+    LineIndex();
+    LineIndex(const GlyphSequence & sequence);
+    virtual ~LineIndex();
+
+    void build(const GlyphSequence & sequence);
+
+    const std::vector<LineMetrics> & lines() const;
+    size_t size() const;
+
+    /**
+    *  @brief
+    *    The extent of the sequence in font face space, as returned by
+    *    Typesetter::typeset before transformation.
+    */
+    const glm::vec2 & extent() const;
+
+    /**
+    *  @brief
+    *    The range [first, last) of lines that intersect the given
+    *    vertical interval (top > bottom) in font face space, i.e., with
+    *    the first baseline at 0 and before line anchor and transform are
+    *    applied. Each line spans its font face's line height.
+    */
+    std::pair<size_t, size_t> linesWithin(float top, float bottom) const;
+
+    /**
+    *  @brief
+    *    The number of depictable glyphs, i.e., vertices, of the lines
+    *    [first, last).
+    */
+    size_t vertexCount(size_t first, size_t last) const;
+
+protected:
+    std::vector<LineMetrics> m_lines;
+    glm::vec2 m_extent;
+
+    float m_base;       // distance from a line's top to its baseline
+    float m_lineHeight;
+};
+
+
+} // namespace gloperate_text
@@ -0,0 +1,29 @@
+
+#pragma once
+
+#include <cstddef>
+
+
+namespace gloperate_text
+{
+
+
+/**
+*  @brief
+*    A line of a typeset sequence in font face space (before line anchor
+*    and transform are applied).
+*/
+struct LineMetrics
+{
+    size_t begin;       // index of the line's first character in the sequence's string
+    size_t end;         // index past the line's last character
+    size_t vertexBegin; // index of the line's first depictable glyph within the sequence's vertices
+    size_t vertexEnd;   // index past the line's last depictable glyph
+    float baseline;     // y of the line's baseline
+    float width;        // advance of the line, excluding trailing glyphs that are not depictable
+    float offset;       // horizontal offset of the line's glyphs due to the sequence's alignment
+    size_t wordEnd;     // line breaking state at the line's begin: the word measured last ends here
+};
+
+
+} // namespace gloperate_text
@@ -1,8 +1,12 @@
 
 #pragma once
 
+#include <cstddef>
+#include <vector>
+
 #include <glm/fwd.hpp>
 
+#include <openll/GlyphSequence.h>
 #include <openll/GlyphVertexCloud.h>
 #include <openll/SuperSampling.h>
 
@@ -13,9 +17,12 @@ namespace gloperate_text
 {
 enum class Alignment : unsigned char;
 
+class ArcLengthTable;
+class ExtentCache;
 class GlyphSequence;
 class FontFace;
 class Glyph;
+struct LineMetrics;
 
 
 class OPENLL_API Typesetter
@@ -26,7 +33,51 @@ public:
 
     static const char32_t & lineFeed();
 
+    // the pen position at a column of a line of fixed pitch (see GlyphSequence::fixedPitch);
+    // glyphs of such sequences are placed at these by all typeset variants and measured alike,
+    // rather than at summed up advances. Line feeds take a column if their glyph has an advance
+    static float columnPen(std::ptrdiff_t column, float pitch);
+
     static glm::vec2 extent(const GlyphSequence & sequence);
+
+    // extents of the sequence word wrapped at each of the given line widths (as passed to
+    // GlyphSequence::setLineWidth, regardless of wordWrap()); a negative width measures the
+    // sequence as extent does. All widths are measured in a single pass over the sequence's
+    // resolved glyphs
+    static std::vector<glm::vec2> extents(
+        const GlyphSequence & sequence
+    ,   const std::vector<float> & lineWidths);
+
+    // extents of strings typeset with the font face at the given font size, as extent would
+    // return for sequences without additional transform, word wrapped at lineWidth (as passed
+    // to GlyphSequence::setLineWidth) if not negative; with lineWidths given, the widths of
+    // each string's lines are provided as well. No sequences are built, no vertices are
+    // typeset, and glyphs missing in the font face are not added, so large batches are
+    // measured in parallel
+    static std::vector<glm::vec2> extents(
+        const FontFace & fontFace
+    ,   float fontSize
+    ,   const std::vector<std::u32string> & strings
+    ,   float lineWidth = -1.f
+    ,   std::vector<std::vector<float>> * lineWidths = nullptr);
+
+    // sets the largest font size at which the sequence's extent (see extent) fits into the
+    // given extent and returns it; wrapped lines are broken anew at the sequence's line width
+    // (as passed to GlyphSequence::setLineWidth). Between the wrap breakpoints, i.e., the line
+    // widths at which lines are broken differently, extents scale linearly with the font size,
+    // so the fitting size is solved for within brackets of these, which are bisected with a
+    // bounded number of measurement passes. If extent is narrower than the line width, a
+    // fitting size below the largest may be returned. If no fitting size is found, the font
+    // size is left unchanged and 0 is returned
+    static float fitFontSize(
+        GlyphSequence & sequence
+    ,   const glm::vec2 & extent);
+
+    // font face space extents computed by extent and extents are memoized in this cache,
+    // if set (none by default); it may be shared by concurrent typesetting
+    static void setExtentCache(ExtentCache * cache);
+    static ExtentCache * extentCache();
+
     static std::pair<glm::vec2, glm::vec2> rectangle(
         const GlyphSequence & sequence, glm::vec3 origin);
 
@@ -35,54 +86,252 @@ public:
     ,   const GlyphVertexCloud::Vertices::iterator & begin
     ,   bool dryrun = false);
 
+    // typesets into caller-provided storage of depictableSize() vertices starting at begin,
+    // e.g., a mapped buffer or an arena; as do all typeset variants, this does not allocate
+    // once the sequence's glyphs are resolved (see GlyphSequence::glyphRun)
+    static glm::vec2 typeset(
+        const GlyphSequence & sequence
+    ,   GlyphVertexCloud::Vertex * begin
+    ,   bool dryrun = false);
+
+    // typesets as above and records the lines (see LineMetrics) as a by-product, e.g., for
+    // selection highlights, underlines, and hit testing; lines is cleared first
+    static glm::vec2 typeset(
+        const GlyphSequence & sequence
+    ,   const GlyphVertexCloud::Vertices::iterator & begin
+    ,   std::vector<LineMetrics> & lines);
+
+    static glm::vec2 typeset(
+        const GlyphSequence & sequence
+    ,   GlyphVertexCloud::Vertex * begin
+    ,   std::vector<LineMetrics> & lines);
+
+    // typesets the sequence in font face space, i.e., without line anchor, transform, font
+    // color, and super sampling, and returns its extent in font face space
+    static glm::vec2 typesetFontSpace(
+        const GlyphSequence & sequence
+    ,   const GlyphVertexCloud::Vertices::iterator & begin);
+
+    static glm::vec2 typesetFontSpace(
+        const GlyphSequence & sequence
+    ,   GlyphVertexCloud::Vertex * begin);
+
+    // copies glyphs typeset in font face space to destination and applies the sequence's line
+    // anchor, transform, font color, and super sampling (as done by typeset)
+    static void transform(
+        const GlyphSequence & sequence
+    ,   const GlyphVertexCloud::Vertices::const_iterator & begin
+    ,   const GlyphVertexCloud::Vertices::const_iterator & end
+    ,   const GlyphVertexCloud::Vertices::iterator & destination);
+
+    static void transform(
+        const GlyphSequence & sequence
+    ,   const GlyphVertexCloud::Vertex * begin
+    ,   const GlyphVertexCloud::Vertex * end
+    ,   GlyphVertexCloud::Vertex * destination);
+
+    // typesets the sequence as a single line (ignoring line feeds, word wrap, and alignment)
+    // and transforms each depictable glyph by its own transform instead of the sequence's
+    // transform, e.g., for placing glyphs along a path
+    static void typeset(
+        const GlyphSequence & sequence
+    ,   const std::vector<glm::mat4> & glyphTransforms
+    ,   const GlyphVertexCloud::Vertices::iterator & begin);
+
+    static void typeset(
+        const GlyphSequence & sequence
+    ,   const std::vector<glm::mat4> & glyphTransforms
+    ,   GlyphVertexCloud::Vertex * begin);
+
+    // typesets the sequence as a single line (ignoring line feeds and word wrap) along a curved
+    // baseline, given in the space the sequence's additional transform applies to and scaled to
+    // its font size, e.g., a polyline or a Bezier curve (see ArcLengthTable::cubicBezier). The
+    // line is aligned (see GlyphSequence::alignment) at the arc length start; each depictable
+    // glyph is rotated into the baseline's direction at its center and glyphs beyond the
+    // baseline's ends continue along its first or last segment. Glyphs are placed in ascending
+    // arc length, so each takes amortized O(1)
+    static void typeset(
+        const GlyphSequence & sequence
+    ,   const ArcLengthTable & baseline
+    ,   float start
+    ,   const GlyphVertexCloud::Vertices::iterator & begin);
+
+    static void typeset(
+        const GlyphSequence & sequence
+    ,   const ArcLengthTable & baseline
+    ,   float start
+    ,   GlyphVertexCloud::Vertex * begin);
+
+    // measures the sequence as typeset does and records its lines (see LineIndex); returns
+    // the extent in font face space
+    static glm::vec2 measureLines(
+        const GlyphSequence & sequence
+    ,   std::vector<LineMetrics> & lines);
+
+    // typesets only the lines [firstLine, lastLine) measured for the unmodified sequence,
+    // into the lines' vertices starting at begin; glyphs are placed as by typeset
+    static void typeset(
+        const GlyphSequence & sequence
+    ,   const std::vector<LineMetrics> & lines
+    ,   size_t firstLine
+    ,   size_t lastLine
+    ,   GlyphVertexCloud::Vertex * begin);
+
+    // updates lines and vertices, typeset (see measureLines and typeset) before the given edit
+    // of the sequence's string, as typeset would after the edit: lines are typeset again only
+    // from the first affected line until line breaks resynchronise; all other settings of the
+    // sequence must be unchanged
+    static glm::vec2 retypeset(
+        const GlyphSequence & sequence
+    ,   const GlyphSequence::Edit & edit
+    ,   std::vector<LineMetrics> & lines
+    ,   GlyphVertexCloud::Vertices & vertices);
+
+    // queries on the sequence typeset as a single line (line feeds and word wrap aside) in
+    // O(log n) using its prefix advances (see GlyphSequence::prefixAdvances); widths and x are
+    // given as for GlyphSequence::setLineWidth, and kerning is assumed not to exceed advances
+
+    // number of leading glyphs whose advances fit into width
+    static size_t fittingPrefix(const GlyphSequence & sequence, float width);
+
+    // width of the glyphs [begin, end) typeset at the beginning of a line
+    static float width(const GlyphSequence & sequence, size_t begin, size_t end);
+
+    // index of the glyph boundary (caret position) closest to x, in [0, size()]
+    static size_t indexAt(const GlyphSequence & sequence, float x);
+
+    // typesets the sequence as a single line as by typeset (yet ignoring line feeds and word
+    // wrap); if it does not fit into width, the longest prefix that fits with the ellipsis
+    // appended is typeset instead (trailing glyphs that are not depictable are dropped).
+    // Writes at most depictableSize() plus the ellipsis' size vertices starting at begin and
+    // provides their number in vertexCount
+    static glm::vec2 typesetTruncated(
+        const GlyphSequence & sequence
+    ,   float width
+    ,   GlyphVertexCloud::Vertex * begin
+    ,   size_t & vertexCount
+    ,   const std::u32string & ellipsis = std::u32string(1, 0x2026));
+
+    // vertical offset of the baseline w.r.t. the sequence's line anchor in font face space
+    static float anchorOffset(const GlyphSequence & sequence);
+
 private:
 
-    static bool typeset_wordwrap(
+    // lines are recorded if given (and not for a dry run)
+    static glm::vec2 typeset_fontspace(
         const GlyphSequence & sequence
-    ,   const glm::vec2 & pen
-    ,   const Glyph & glyph
-    ,   const std::u32string::const_iterator & index
-    ,   std::u32string::const_iterator & safe_forward);
+    ,   GlyphVertexCloud::Vertex * begin
+    ,   bool dryrun
+    ,   bool transform
+    ,   std::vector<LineMetrics> * lines);
+
+    // kernels specialised for the sequence's word wrap, fixed pitch (see
+    // GlyphSequence::fixedPitch), and alignment, and for whether to transform
+    template <bool WordWrap, bool FixedPitch>
+    static glm::vec2 typeset_select(
+        const GlyphSequence & sequence
+    ,   GlyphVertexCloud::Vertex * begin
+    ,   bool dryrun
+    ,   bool transform
+    ,   std::vector<LineMetrics> * lines);
+
+    template <bool WordWrap, bool FixedPitch, bool Transform, Alignment Align>
+    static glm::vec2 typeset_kernel(
+        const GlyphSequence & sequence
+    ,   GlyphVertexCloud::Vertex * begin
+    ,   std::vector<LineMetrics> * lines);
+
+    // the kernel for fixed pitch: lines are broken by column counts and each glyph's quad,
+    // precomputed by the font face (see FontFace::asciiQuads), is placed at its column's pen
+    // (see columnPen) without any per glyph lookups; lines are then transformed as by
+    // typeset_kernel
+    template <bool WordWrap, bool Transform, Alignment Align>
+    static glm::vec2 typeset_fixed_kernel(
+        const GlyphSequence & sequence
+    ,   GlyphVertexCloud::Vertex * begin
+    ,   std::vector<LineMetrics> * lines);
 
-    static std::u32string::const_iterator typeset_forward(
+    // extent in font face space, word wrapped at lineWidth if not negative
+    static glm::vec2 typeset_measure(
         const GlyphSequence & sequence
-    ,   const std::u32string::const_iterator & begin
-    ,   float & width);
+    ,   float lineWidth);
+
+    // extent of resolved glyphs of the given fixed pitch (see GlyphSequence::resolve); the
+    // width of each line is recorded if lineWidths is given
+    static glm::vec2 typeset_measure(
+        const FontFace & fontFace
+    ,   const std::u32string & string
+    ,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+    ,   float pitch
+    ,   float lineWidth
+    ,   std::vector<float> * lineWidths);
+
+    // measures all line widths (in font face space, negative ones without word wrap) in
+    // lockstep, with a line breaker per width
+    template <bool FixedPitch>
+    static void typeset_measure_widths(
+        const FontFace & fontFace
+    ,   const std::u32string & string
+    ,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+    ,   float pitch
+    ,   const std::vector<float> & lineWidths
+    ,   std::vector<glm::vec2> & extents);
+
+    template <bool WordWrap, bool FixedPitch>
+    static glm::vec2 typeset_measure_kernel(
+        const FontFace & fontFace
+    ,   const std::u32string & string
+    ,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+    ,   float pitch
+    ,   float lineWidth
+    ,   std::vector<float> * lineWidths);
+
+    // extent of resolved glyphs word wrapped at lineWidth, and the line widths [x, y) at which
+    // lines are broken alike
+    static glm::vec2 typeset_measure_bracket(
+        const FontFace & fontFace
+    ,   const std::u32string & string
+    ,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+    ,   float pitch
+    ,   float lineWidth
+    ,   glm::vec2 & lineWidths);
 
     static void typeset_glyph(
         const FontFace & fontFace
     ,   const glm::vec2 & pen
     ,   const Glyph & glyph
-    ,   const GlyphVertexCloud::Vertices::iterator & vertex);
+    ,   GlyphVertexCloud::Vertex * vertex);
 
     static void typeset_extent(
         const FontFace & fontFace
-    ,   std::u32string::const_iterator index
-    ,   const std::u32string::const_iterator & begin
-    ,   glm::vec2 & pen
+    ,   const glm::vec2 & pen
     ,   glm::vec2 & extent);
 
-    static void typeset_align(
-        const glm::vec2 & pen
-    ,   const Alignment alignment
-    ,   const GlyphVertexCloud::Vertices::iterator & begin
-    ,   const GlyphVertexCloud::Vertices::iterator & end);
+    // horizontal offset of a line's glyphs w.r.t. the line's width
+    static float align_offset(
+        float penX
+    ,   const Alignment alignment);
 
-    static void anchor_transform(
-        const GlyphSequence & sequence
-    ,   const GlyphVertexCloud::Vertices::iterator & begin
-    ,   const GlyphVertexCloud::Vertices::iterator & end);
+    // vertical offset of the glyphs w.r.t. the sequence's line anchor
+    static float anchor_offset(const GlyphSequence & sequence);
 
+    // offsets the glyphs' origins in font face space and applies the transform, writing the
+    // result to destination in a single pass (SSE accelerated where available)
     static void vertex_transform(
-        const glm::mat4 & sequence
+        const glm::mat4 & transform
+    ,   const glm::vec2 & offset
     ,   const glm::vec4 & fontColor
     ,   const SuperSampling & superSampling
-    ,   const GlyphVertexCloud::Vertices::iterator & begin
-    ,   const GlyphVertexCloud::Vertices::iterator & end);
+    ,   const GlyphVertexCloud::Vertex * begin
+    ,   const GlyphVertexCloud::Vertex * end
+    ,   GlyphVertexCloud::Vertex * destination);
 
     static glm::vec2 extent_transform(
         const GlyphSequence & sequence
     ,   const glm::vec2 & extent);
+
+private:
+    static ExtentCache * s_extentCache;
 };
 
 
@@ -0,0 +1,77 @@
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/openll_api.h>
+
+namespace gloperate_text
+{
+
+struct Label;
+
+
+enum class ClusterContent : unsigned char
+{
+    TopPriority, // a cluster shows the text of its highest priority label
+    Count        // a cluster shows the number of aggregated labels
+};
+
+// Hierarchical greedy clustering of label point locations (similar to supercluster).
+// The hierarchy is built once for a set of labels; afterwards, the aggregated labels
+// of a zoom level within a viewport can be queried and passed to the layout algorithms.
+// At zoom level z, labels within radius / 2^z of a cluster's location are merged into it.
+class OPENLL_API LabelClusterIndex
+{
+public:
+    LabelClusterIndex(float radius = 0.05f, unsigned int minZoom = 0, unsigned int maxZoom = 16);
+    virtual ~LabelClusterIndex();
+
+    float radius() const;
+    unsigned int minZoom() const;
+    unsigned int maxZoom() const;
+
+    // builds the cluster hierarchy in O(N log N) per zoom level
+    void build(const std::vector<Label> & labels);
+
+    std::size_t size(unsigned int zoom) const;
+
+    // returns the (aggregated) labels of the given zoom level within the rectangle,
+    // labels has to be the same label set the index was built from
+    std::vector<Label> query(const std::vector<Label> & labels,
+        const glm::vec2 & lowerLeft, const glm::vec2 & upperRight, unsigned int zoom,
+        ClusterContent content = ClusterContent::TopPriority) const;
+
+protected:
+    struct Cluster
+    {
+        glm::vec2 location;
+        std::uint32_t count;
+        unsigned int priority;
+        std::uint32_t representative; // index of the highest priority label
+    };
+
+    // clusters of a single zoom level, stored as static kd-tree
+    struct Level
+    {
+        std::vector<Cluster> clusters;
+        std::vector<std::uint32_t> ids;
+        std::vector<glm::vec2> locations;
+    };
+
+    const Level & level(unsigned int zoom) const;
+
+protected:
+    float m_radius;
+    unsigned int m_minZoom;
+    unsigned int m_maxZoom;
+
+    // levels from minZoom to maxZoom + 1, the latter containing the unclustered labels
+    std::vector<Level> m_levels;
+};
+
+
+} // namespace gloperate_text
@@ -0,0 +1,64 @@
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/openll_api.h>
+#include <openll/layout/LabelArea.h>
+
+namespace gloperate_text
+{
+
+
+// A polygon (outer ring and optional holes, even-odd rule) to be labelled at its most
+// interior point. The boundary segments are stored in a bounding volume hierarchy, so
+// distance and containment queries take logarithmic time for typical polygons.
+class OPENLL_API LabelPolygon
+{
+public:
+    LabelPolygon(const std::vector<std::vector<glm::vec2>> & rings);
+    virtual ~LabelPolygon();
+
+    bool contains(const glm::vec2 & point) const;
+    bool contains(const LabelArea & area) const;
+
+    // distance to the boundary, positive inside and negative outside
+    float signedDistance(const glm::vec2 & point) const;
+
+    // the pole of inaccessibility, i.e., the interior point furthest from the boundary,
+    // found up to precision by a quadtree subdivision with a priority queue (polylabel)
+    glm::vec2 poleOfInaccessibility(float precision, float * distance = nullptr) const;
+
+    // candidate areas of the given extent for layout::Label::candidates: centered at the
+    // pole and at the four positions around it; areas that do not fit into the polygon are
+    // dropped, but the centered area is kept if none fits
+    std::vector<LabelArea> candidates(const glm::vec2 & extent, float precision) const;
+
+protected:
+    struct Segment
+    {
+        glm::vec2 a;
+        glm::vec2 b;
+    };
+
+    // children of inner nodes are stored at first and first + 1, leaves reference count segments
+    struct Node
+    {
+        glm::vec2 lowerLeft;
+        glm::vec2 upperRight;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    void build(std::uint32_t node, std::uint32_t begin, std::uint32_t end);
+
+protected:
+    std::vector<Segment> m_segments;
+    std::vector<Node> m_nodes;
+};
+
+
+} // namespace gloperate_text
@@ -0,0 +1,37 @@
+
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <openll/openll_api.h>
+#include <openll/layout/LabelArea.h>
+#include <openll/layout/RelativeLabelPosition.h>
+
+namespace gloperate_text
+{
+
+// A label footprint that is rotated w.r.t. the layout axes, e.g., due to a rotation
+// within the label's additional transform. The box spans origin + s * xAxis + t * yAxis
+// for s, t in [0, 1]. Overlap tests use the axis-aligned bounding boxes as broad phase
+// and the separating axis theorem only for boxes that are actually rotated.
+struct OPENLL_API OrientedLabelArea
+{
+public:
+    bool overlaps(const OrientedLabelArea & other) const;
+    bool paddedOverlaps(const OrientedLabelArea & other, const glm::vec2 & relativePadding) const;
+    float overlapArea(const OrientedLabelArea & other) const;
+    float paddedOverlapArea(const OrientedLabelArea & other, const glm::vec2 & relativePadding) const;
+    float area() const;
+
+    bool isAxisAligned() const;
+    LabelArea boundingBox() const;
+    OrientedLabelArea padded(const glm::vec2 & relativePadding) const;
+
+public:
+    glm::vec2 origin;
+    glm::vec2 xAxis;
+    glm::vec2 yAxis;
+    RelativeLabelPosition position;
+};
+
+} // namespace gloperate_text
@@ -0,0 +1,55 @@
+
+#pragma once
+
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <openll/openll_api.h>
+#include <openll/layout/LabelArea.h>
+#include <openll/layout/OrientedLabelArea.h>
+
+namespace gloperate_text
+{
+
+class ArcLengthTable;
+class GlyphSequence;
+
+
+// A glyph sequence placed along a polyline (e.g., a road or river name). Every depictable
+// glyph gets its own transform, to be passed to Typesetter::typeset, and its own footprint.
+// The footprint of the whole label is the union of the glyph areas.
+struct OPENLL_API PolylineLabel
+{
+public:
+    bool overlaps(const OrientedLabelArea & other) const;
+    bool overlaps(const PolylineLabel & other) const;
+    bool paddedOverlaps(const OrientedLabelArea & other, const glm::vec2 & relativePadding) const;
+    bool paddedOverlaps(const PolylineLabel & other, const glm::vec2 & relativePadding) const;
+
+public:
+    float start;      // arc length of the label's begin
+    float curvature;  // largest angle (radians) between adjacent glyphs
+    LabelArea bounds; // bounding box of all glyph areas
+    std::vector<glm::mat4> glyphTransforms;
+    std::vector<OrientedLabelArea> glyphAreas;
+};
+
+
+namespace layout
+{
+
+// places the sequence's glyphs along the path, starting at the given arc length; the
+// sequence is typeset as a single line and oriented to be read from left to right
+PolylineLabel OPENLL_API polylineLabel(const GlyphSequence & sequence, const ArcLengthTable & path, float start);
+
+// evaluates candidates every spacing units along the path and returns the ones whose
+// curvature does not exceed maxAngle, sorted by ascending curvature; each candidate
+// costs O(g log n) for g glyphs and n path points
+std::vector<PolylineLabel> OPENLL_API polylineLabels(const GlyphSequence & sequence, const ArcLengthTable & path,
+    float spacing, float maxAngle = 0.5f);
+
+}
+
+} // namespace gloperate_text
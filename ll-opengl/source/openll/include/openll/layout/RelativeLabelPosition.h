@@ -11,10 +11,11 @@ namespace gloperate_text
 
 enum class RelativeLabelPosition : unsigned char
 {
-    UpperRight, UpperLeft, LowerRight, LowerLeft, Hidden
+    UpperRight, UpperLeft, LowerRight, LowerLeft, Hidden, Centered
 };
 
 glm::vec2 OPENLL_API labelOrigin(RelativeLabelPosition position, const glm::vec2 & origin, const glm::vec2 & extent);
+glm::vec2 OPENLL_API labelOrigin(RelativeLabelPosition position, const glm::vec2 & origin, const glm::vec2 & xAxis, const glm::vec2 & yAxis);
 bool OPENLL_API isVisible(RelativeLabelPosition position);
 RelativeLabelPosition OPENLL_API relativeLabelPosition(const glm::vec2 & offset, const glm::vec2 & extent);
 
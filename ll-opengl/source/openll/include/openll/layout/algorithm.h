@@ -12,6 +12,7 @@ namespace gloperate_text
 
 struct Label;
 struct LabelArea;
+struct LeaderLine;
 
 namespace layout
 {
@@ -24,6 +25,11 @@ PenaltyFunction OPENLL_API overlapArea;
 PenaltyFunction OPENLL_API overlapCount;
 PenaltyFunction OPENLL_API standard;
 
+// removes labels whose text repeats the text of a higher priority label (or an earlier one of
+// equal priority) within minDistance of its point location, in expected linear time;
+// meant to run ahead of the placement algorithms, the order of the remaining labels is kept
+void OPENLL_API suppressDuplicates(std::vector<Label> & labels, float minDistance);
+
 void OPENLL_API constant(std::vector<Label> & labels);
 void OPENLL_API random(std::vector<Label> & labels);
 
@@ -32,6 +38,11 @@ void OPENLL_API greedy                 (std::vector<Label> & labels, PenaltyFunc
 void OPENLL_API discreteGradientDescent(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding = {0.2f, 0.2f});
 void OPENLL_API simulatedAnnealing     (std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding = {0.2f, 0.2f});
 
+// continuous placement: overlapping labels repel each other while being pulled back to their
+// point locations; repulsion uses a uniform grid, so each iteration takes expected linear time;
+// leaderLines is replaced by one line per label that ends up detached from its point location
+void OPENLL_API forceDirected(std::vector<Label> & labels, std::vector<LeaderLine> & leaderLines, const glm::vec2 & relativePadding = {0.2f, 0.2f}, unsigned int iterations = 64);
+
 }
 
 }
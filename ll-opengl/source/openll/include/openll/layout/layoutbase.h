@@ -1,10 +1,13 @@
 #pragma once
 
+#include <vector>
+
 #include <glm/vec2.hpp>
 
 #include <openll/LineAnchor.h>
 #include <openll/Alignment.h>
 #include <openll/GlyphSequence.h>
+#include <openll/layout/LabelArea.h>
 
 #include <openll/openll_api.h>
 
@@ -19,6 +22,7 @@ struct OPENLL_API LabelPlacement
     gloperate_text::Alignment alignment;
     gloperate_text::LineAnchor lineAnchor;
     bool display;
+    float lineWidth; // if greater than 0, the sequence is word wrapped at this width
 };
 
 struct OPENLL_API Label
@@ -27,6 +31,19 @@ struct OPENLL_API Label
     glm::vec2 pointLocation;
     unsigned int priority;
     LabelPlacement placement;
+    // if not empty, the layout algorithms choose among these areas (e.g., from polygon
+    // labelling) instead of the four positions around pointLocation
+    std::vector<LabelArea> candidates;
+    // alternative line widths (see GlyphSequence::setLineWidth), each of which adds a word
+    // wrapped shape of the label to the four positions around pointLocation
+    std::vector<float> lineWidths;
+};
+
+// connects a label that was moved away from its point location with that location
+struct OPENLL_API LeaderLine
+{
+    glm::vec2 start; // the label's point location
+    glm::vec2 end;   // the closest point on the label's area
 };
 
 GlyphSequence OPENLL_API applyPlacement(const Label & label);
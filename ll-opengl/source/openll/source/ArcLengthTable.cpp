@@ -0,0 +1,141 @@
+
+#include <openll/ArcLengthTable.h>
+
+#include <cassert>
+#include <algorithm>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+
+namespace gloperate_text
+{
+
+
+ArcLengthTable::ArcLengthTable()
+{
+}
+
+ArcLengthTable::ArcLengthTable(const std::vector<glm::vec2> & polyline)
+{
+    m_points.reserve(polyline.size());
+    m_lengths.reserve(polyline.size());
+
+    for (const auto & point : polyline)
+    {
+        if (m_points.empty())
+        {
+            m_points.push_back(point);
+            m_lengths.push_back(0.f);
+            continue;
+        }
+
+        const auto length = glm::distance(m_points.back(), point);
+        if (length <= 0.f)
+            continue;
+
+        m_points.push_back(point);
+        m_lengths.push_back(m_lengths.back() + length);
+    }
+}
+
+ArcLengthTable::~ArcLengthTable()
+{
+}
+
+ArcLengthTable ArcLengthTable::cubicBezier(
+    const std::vector<glm::vec2> & controlPoints
+,   const size_t subdivisions)
+{
+    assert(controlPoints.size() % 3 == 1);
+    assert(subdivisions > 0);
+
+    auto polyline = std::vector<glm::vec2>();
+    polyline.reserve((controlPoints.size() / 3) * subdivisions + 1);
+    if (!controlPoints.empty())
+        polyline.push_back(controlPoints.front());
+
+    for (size_t i = 0; i + 3 < controlPoints.size(); i += 3)
+    {
+        const auto & p0 = controlPoints[i];
+        const auto & p1 = controlPoints[i + 1];
+        const auto & p2 = controlPoints[i + 2];
+        const auto & p3 = controlPoints[i + 3];
+
+        for (size_t j = 1; j <= subdivisions; ++j)
+        {
+            const auto t = static_cast<float>(j) / static_cast<float>(subdivisions);
+            const auto u = 1.f - t;
+            polyline.push_back(p0 * (u * u * u) + p1 * (3.f * u * u * t) + p2 * (3.f * u * t * t) + p3 * (t * t * t));
+        }
+    }
+
+    return ArcLengthTable(polyline);
+}
+
+const std::vector<glm::vec2> & ArcLengthTable::points() const
+{
+    return m_points;
+}
+
+float ArcLengthTable::length() const
+{
+    return m_lengths.empty() ? 0.f : m_lengths.back();
+}
+
+size_t ArcLengthTable::segment(const float arcLength) const
+{
+    assert(m_points.size() > 1);
+
+    // first cumulative length beyond arcLength marks the segment's end
+    const auto end = std::upper_bound(m_lengths.begin() + 1, m_lengths.end() - 1, arcLength);
+    return static_cast<size_t>(end - m_lengths.begin()) - 1;
+}
+
+size_t ArcLengthTable::segment(const float arcLength, const size_t hint) const
+{
+    assert(m_points.size() > 1);
+
+    // the same segment as found by the binary search, walking from the hint
+    auto index = glm::min(hint, m_points.size() - 2);
+    while (index > 0 && m_lengths[index] > arcLength)
+        --index;
+    while (index + 2 < m_points.size() && m_lengths[index + 1] <= arcLength)
+        ++index;
+
+    return index;
+}
+
+glm::vec2 ArcLengthTable::position(const float arcLength) const
+{
+    if (m_points.size() < 2)
+        return m_points.empty() ? glm::vec2(0.f) : m_points.front();
+
+    return position(glm::clamp(arcLength, 0.f, length()), segment(arcLength));
+}
+
+glm::vec2 ArcLengthTable::position(const float arcLength, const size_t segment) const
+{
+    assert(segment + 1 < m_points.size());
+
+    const auto t = (arcLength - m_lengths[segment]) / (m_lengths[segment + 1] - m_lengths[segment]);
+    return glm::mix(m_points[segment], m_points[segment + 1], t);
+}
+
+glm::vec2 ArcLengthTable::tangent(const float arcLength) const
+{
+    if (m_points.size() < 2)
+        return glm::vec2(1.f, 0.f);
+
+    return segmentTangent(segment(arcLength));
+}
+
+glm::vec2 ArcLengthTable::segmentTangent(const size_t segment) const
+{
+    assert(segment + 1 < m_points.size());
+
+    return (m_points[segment + 1] - m_points[segment]) / (m_lengths[segment + 1] - m_lengths[segment]);
+}
+
+
+} // namespace gloperate_text
@@ -0,0 +1,126 @@
+
+#include <openll/ExtentCache.h>
+
+#include <cassert>
+#include <functional>
+#include <string>
+
+
+namespace gloperate_text
+{
+
+
+bool ExtentCache::Key::operator==(const Key & other) const
+{
+    return hash == other.hash && fontFace == other.fontFace && lineWidth == other.lineWidth
+        && length == other.length && std::char_traits<char32_t>::compare(string, other.string, length) == 0;
+}
+
+size_t ExtentCache::KeyHash::operator()(const Key & key) const
+{
+    return key.hash;
+}
+
+ExtentCache::Key ExtentCache::key(const std::u32string & string, const FontFace * fontFace, const float lineWidth)
+{
+    auto hash = std::hash<std::u32string>()(string);
+    hash ^= std::hash<const FontFace *>()(fontFace) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<float>()(lineWidth) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    return { string.data(), string.size(), fontFace, lineWidth, hash };
+}
+
+
+ExtentCache::ExtentCache(const size_t capacity)
+: m_capacity(capacity)
+, m_hits(0)
+, m_misses(0)
+{
+    assert(capacity > 0);
+    m_index.reserve(capacity);
+}
+
+ExtentCache::~ExtentCache()
+{
+}
+
+bool ExtentCache::find(const std::u32string & string, const FontFace * fontFace, const float lineWidth, glm::vec2 & extent)
+{
+    // hashed before locking; the string is not copied
+    const auto lookup = key(string, fontFace, lineWidth);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto found = m_index.find(lookup);
+    if (found == m_index.end())
+    {
+        ++m_misses;
+        return false;
+    }
+
+    // mark as most recently used
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+
+    extent = found->second->extent;
+    ++m_hits;
+    return true;
+}
+
+void ExtentCache::insert(const std::u32string & string, const FontFace * fontFace, const float lineWidth, const glm::vec2 & extent)
+{
+    const auto lookup = key(string, fontFace, lineWidth);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    const auto found = m_index.find(lookup);
+    if (found != m_index.end())
+    {
+        // inserted concurrently by another thread
+        found->second->extent = extent;
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return;
+    }
+
+    if (m_entries.size() == m_capacity)
+    {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+    }
+
+    // the indexed key refers to the copy of the string held by the entry
+    m_entries.push_front({ string, lookup, extent });
+    auto & entry = m_entries.front();
+    entry.key.string = entry.string.data();
+    m_index.emplace(entry.key, m_entries.begin());
+}
+
+void ExtentCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_index.clear();
+    m_entries.clear();
+}
+
+size_t ExtentCache::capacity() const
+{
+    return m_capacity;
+}
+
+size_t ExtentCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t ExtentCache::hits() const
+{
+    return m_hits;
+}
+
+size_t ExtentCache::misses() const
+{
+    return m_misses;
+}
+
+
+} // namespace gloperate_text
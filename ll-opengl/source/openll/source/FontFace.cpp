@@ -1,6 +1,8 @@
 
 #include <openll/FontFace.h>
 
+#include <algorithm>
+
 
 namespace gloperate_text
 {
@@ -10,7 +12,10 @@ FontFace::FontFace()
 : m_ascent (0.f)
 , m_descent(0.f)
 , m_linegap(0.f)
+, m_fixedAdvance(0.f)
 {
+    std::fill(std::begin(m_asciiGlyphs), std::end(m_asciiGlyphs), nullptr);
+    std::fill(std::begin(m_asciiQuads), std::end(m_asciiQuads), AsciiQuad{ glm::vec4(0.f), glm::vec4(0.f), false });
 }
 
 FontFace::~FontFace()
@@ -118,6 +123,8 @@ void FontFace::setGlyphTexturePadding(const glm::vec4 & padding)
     assert(padding[3] >= 0.f);
 
     m_glyphTexturePadding = padding;
+    for (auto index = GlyphIndex(0); index < 128; ++index)
+        updateAsciiQuad(index);
 }
 
 globjects::Texture * FontFace::glyphTexture() const
@@ -137,6 +144,9 @@ bool FontFace::hasGlyph(const GlyphIndex index) const
 
 Glyph & FontFace::glyph(const GlyphIndex index)
 {
+    if (index < 128 && m_asciiGlyphs[index])
+        return *m_asciiGlyphs[index];
+
     const auto existing = m_glyphs.find(index);
     if (existing != m_glyphs.cend())
         return existing->second;
@@ -144,12 +154,18 @@ Glyph & FontFace::glyph(const GlyphIndex index)
     auto glyph = Glyph();
     glyph.setIndex(index);
 
+    // references to elements of an unordered map remain valid on insertion
     const auto inserted = m_glyphs.emplace(glyph.index(), glyph);
+    if (index < 128)
+        m_asciiGlyphs[index] = &inserted.first->second;
     return inserted.first->second;
 }
 
 const Glyph & FontFace::glyph(const GlyphIndex index) const
 {
+    if (index < 128 && m_asciiGlyphs[index])
+        return *m_asciiGlyphs[index];
+
     const auto existing = m_glyphs.find(index);
     if (existing != m_glyphs.cend())
         return existing->second;
@@ -162,7 +178,15 @@ void FontFace::addGlyph(const Glyph & glyph)
 {
     assert(m_glyphs.find(glyph.index()) == m_glyphs.cend());
 
-    m_glyphs.emplace(glyph.index(), glyph);
+    const auto inserted = m_glyphs.emplace(glyph.index(), glyph);
+    if (glyph.index() < 128)
+    {
+        m_asciiGlyphs[glyph.index()] = &inserted.first->second;
+        updateAsciiQuad(glyph.index());
+    }
+
+    if (glyph.advance() != m_fixedAdvance || glyph.hasKerning())
+        m_fixedAdvance = 0.f;
 }
 
 std::vector<GlyphIndex> FontFace::glyphs() const
@@ -198,6 +222,51 @@ void FontFace::setKerning(const GlyphIndex index, const GlyphIndex subsequentInd
     }
 
     it->second.setKerning(subsequentIndex, kerning);
+    m_fixedAdvance = 0.f;
+}
+
+float FontFace::fixedAdvance() const
+{
+    return m_fixedAdvance;
+}
+
+void FontFace::detectFixedAdvance()
+{
+    // glyphs may have been modified directly
+    for (auto index = GlyphIndex(0); index < 128; ++index)
+        updateAsciiQuad(index);
+
+    m_fixedAdvance = m_glyphs.empty() ? 0.f : m_glyphs.cbegin()->second.advance();
+
+    for (const auto & glyph : m_glyphs)
+    {
+        if (glyph.second.advance() == m_fixedAdvance && !glyph.second.hasKerning())
+            continue;
+
+        m_fixedAdvance = 0.f;
+        return;
+    }
+}
+
+const FontFace::AsciiQuad * FontFace::asciiQuads() const
+{
+    return m_asciiQuads;
+}
+
+void FontFace::updateAsciiQuad(const GlyphIndex index)
+{
+    assert(index < 128);
+
+    auto & quad = m_asciiQuads[index];
+    const auto glyph = m_asciiGlyphs[index];
+    quad.depictable = glyph && glyph->depictable();
+    if (!quad.depictable)
+        return;
+
+    // as typeset by the Typesetter
+    quad.rect = glm::vec4(glyph->bearing().x - m_glyphTexturePadding[3]
+        , glyph->bearing().y - glyph->extent().y + m_glyphTexturePadding[0], glyph->extent().x, glyph->extent().y);
+    quad.uvRect = glm::vec4(glyph->subTextureOrigin(), glyph->subTextureOrigin() + glyph->subTextureExtent());
 }
 
 
@@ -123,6 +123,8 @@ FontFace * FontLoader::load(const std::string & filename, bool headless) const
         }
     }
 
+    fontFace->detectFixedAdvance();
+
     if (headless || fontFace->glyphTexture())
         return fontFace;
 
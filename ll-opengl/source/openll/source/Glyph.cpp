@@ -109,5 +109,10 @@ void Glyph::setKerning(GlyphIndex subsequentIndex, const float kerning)
     m_kernings[subsequentIndex] = kerning;
 }
 
+bool Glyph::hasKerning() const
+{
+    return !m_kernings.empty();
+}
+
 
 } // namespace gloperate_text
@@ -1,6 +1,10 @@
 
 #include <openll/GlyphSequence.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
 #include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
@@ -8,6 +12,75 @@
 #include <glm/gtc/matrix_transform.hpp>
 
 #include <openll/FontFace.h>
+#include <openll/Glyph.h>
+#include <openll/Typesetter.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OPENLL_GLYPHSEQUENCE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace
+{
+
+const auto replacementCharacter = static_cast<char32_t>(0xFFFD);
+
+// decodes the code point starting at source[i] and advances i past it; an invalid or truncated
+// sequence yields U+FFFD and is skipped up to its longest valid prefix (as recommended by the
+// Unicode standard), which rejects overlong encodings, surrogates, and code points > U+10FFFF
+char32_t decodeUtf8(const unsigned char * source, const size_t length, size_t & i)
+{
+    const auto lead = source[i++];
+    if (lead < 0x80)
+        return lead;
+
+    auto count = 0;
+    auto codePoint = char32_t(0);
+    auto lower = static_cast<unsigned char>(0x80);
+    auto upper = static_cast<unsigned char>(0xBF);
+
+    if (lead >= 0xC2 && lead <= 0xDF)
+    {
+        count = 1;
+        codePoint = lead & 0x1F;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF)
+    {
+        count = 2;
+        codePoint = lead & 0x0F;
+        lower = lead == 0xE0 ? 0xA0 : lower;
+        upper = lead == 0xED ? 0x9F : upper;
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4)
+    {
+        count = 3;
+        codePoint = lead & 0x07;
+        lower = lead == 0xF0 ? 0x90 : lower;
+        upper = lead == 0xF4 ? 0x8F : upper;
+    }
+    else
+        return replacementCharacter;
+
+    for (; count > 0; --count)
+    {
+        if (i == length || source[i] < lower || source[i] > upper)
+            return replacementCharacter;
+
+        codePoint = (codePoint << 6) | (source[i++] & 0x3F);
+        lower = 0x80;
+        upper = 0xBF;
+    }
+    return codePoint;
+}
+
+// line feeds are usually not part of a font face and resolve to empty glyphs
+bool fitsPitch(const char32_t c, const gloperate_text::Glyph & glyph, const float pitch)
+{
+    return glyph.advance() == pitch || (c == '\x0A' && glyph.advance() == 0.f);
+}
+
+}
 
 
 namespace gloperate_text
@@ -15,7 +88,9 @@ namespace gloperate_text
 
 
 GlyphSequence::GlyphSequence()
-: m_wordWrap(false)
+: m_edited(false)
+, m_edit({ 0, 0, 0 })
+, m_wordWrap(false)
 , m_lineWidth(0.f)
 , m_alignment(Alignment::LeftAligned)
 , m_anchor(LineAnchor::Baseline)
@@ -24,7 +99,10 @@ GlyphSequence::GlyphSequence()
 , m_fontSize(12.f)
 , m_superSampling(SuperSampling::Quincunx)
 , m_transformValid(false)
-
+, m_glyphRunValid(false)
+, m_depictableSize(0)
+, m_fixedPitch(0.f)
+, m_prefixAdvancesValid(false)
 {
 }
 
@@ -39,13 +117,9 @@ size_t GlyphSequence::size() const
 
 size_t GlyphSequence::depictableSize() const
 {
-    auto count = size_t(0);
-    for (const auto & c : m_string)
-    {
-        if (m_fontFace->depictable(c))
-            ++count;
-    }
-    return count;
+    if (!m_glyphRunValid)
+        resolveGlyphs();
+    return m_depictableSize;
 }
 
 const std::u32string & GlyphSequence::string() const
@@ -58,9 +132,201 @@ void GlyphSequence::setString(const std::u32string & string)
     if (m_string.compare(string) == 0)
         return;
 
+    recordEdit(0, m_string.size(), string.size());
+
+    m_glyphRunValid = false;
     m_string = string;
 }
 
+void GlyphSequence::setString(const std::string & utf8)
+{
+    setString(utf8.data(), utf8.size());
+}
+
+void GlyphSequence::setString(const char * utf8, const size_t length)
+{
+    const auto source = reinterpret_cast<const unsigned char *>(utf8);
+    const auto oldSize = m_string.size();
+
+    // there are at most as many code points as bytes; each code point is compared to the
+    // previous string right before it is overwritten, so no copy of the string is needed
+    m_string.resize(std::max(oldSize, length));
+    auto changed = false;
+
+    size_t i = 0;
+    size_t size = 0;
+
+#ifdef OPENLL_GLYPHSEQUENCE_SSE2
+    const auto zero = _mm_setzero_si128();
+
+    while (i + 16 <= length)
+    {
+        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(source + i));
+        if (_mm_movemask_epi8(bytes) != 0)
+        {
+            // decode the block's first non-ASCII sequence, then continue with blocks
+            for (const auto end = i + 16; i < end && source[i] < 0x80; ++size, ++i)
+            {
+                changed = changed || size >= oldSize || m_string[size] != source[i];
+                m_string[size] = source[i];
+            }
+            const auto codePoint = decodeUtf8(source, length, i);
+            changed = changed || size >= oldSize || m_string[size] != codePoint;
+            m_string[size++] = codePoint;
+            continue;
+        }
+
+        // zero-extend 16 ASCII bytes to 16 code points
+        const auto low = _mm_unpacklo_epi8(bytes, zero);
+        const auto high = _mm_unpackhi_epi8(bytes, zero);
+        const __m128i codePoints[4] = { _mm_unpacklo_epi16(low, zero), _mm_unpackhi_epi16(low, zero)
+            , _mm_unpacklo_epi16(high, zero), _mm_unpackhi_epi16(high, zero) };
+
+        const auto destination = reinterpret_cast<__m128i *>(&m_string[size]);
+        if (!changed && size + 16 <= oldSize)
+        {
+            auto equal = _mm_set1_epi32(-1);
+            for (auto k = 0; k < 4; ++k)
+                equal = _mm_and_si128(equal, _mm_cmpeq_epi32(codePoints[k], _mm_loadu_si128(destination + k)));
+            changed = _mm_movemask_epi8(equal) != 0xFFFF;
+        }
+        else
+            changed = true;
+
+        for (auto k = 0; k < 4; ++k)
+            _mm_storeu_si128(destination + k, codePoints[k]);
+
+        i += 16;
+        size += 16;
+    }
+#endif
+
+    while (i < length)
+    {
+        const auto codePoint = decodeUtf8(source, length, i);
+        changed = changed || size >= oldSize || m_string[size] != codePoint;
+        m_string[size++] = codePoint;
+    }
+
+    m_string.resize(size);
+    if (!changed && size == oldSize)
+        return;
+
+    recordEdit(0, oldSize, size);
+    m_glyphRunValid = false;
+}
+
+void GlyphSequence::insert(const size_t position, const std::u32string & string)
+{
+    assert(position <= m_string.size());
+
+    if (string.empty())
+        return;
+
+    m_string.insert(position, string);
+    spliceGlyphs(position, 0, string.size());
+    recordEdit(position, 0, string.size());
+}
+
+void GlyphSequence::erase(const size_t position, size_t count)
+{
+    assert(position <= m_string.size());
+
+    count = std::min(count, m_string.size() - position);
+    if (count == 0)
+        return;
+
+    m_string.erase(position, count);
+    spliceGlyphs(position, count, 0);
+    recordEdit(position, count, 0);
+}
+
+void GlyphSequence::append(const std::u32string & string)
+{
+    insert(m_string.size(), string);
+}
+
+bool GlyphSequence::edited() const
+{
+    return m_edited;
+}
+
+const GlyphSequence::Edit & GlyphSequence::edit() const
+{
+    return m_edit;
+}
+
+void GlyphSequence::resetEdit()
+{
+    m_edited = false;
+    m_edit = { 0, 0, 0 };
+}
+
+const std::vector<GlyphSequence::ResolvedGlyph> & GlyphSequence::glyphRun() const
+{
+    if (!m_glyphRunValid)
+        resolveGlyphs();
+    return m_glyphRun;
+}
+
+float GlyphSequence::fixedPitch() const
+{
+    if (!m_glyphRunValid)
+        resolveGlyphs();
+    return m_fixedPitch;
+}
+
+const std::vector<float> & GlyphSequence::prefixAdvances() const
+{
+    const auto & run = glyphRun();
+    if (m_prefixAdvancesValid)
+        return m_prefixAdvances;
+
+    // summed up in the order typeset advances the pen, to obtain identical positions; with
+    // fixed pitch, the pens are at columns as typeset places them
+    m_prefixAdvances.resize(run.size() + 1);
+    m_prefixAdvances[0] = 0.f;
+    auto column = std::ptrdiff_t(0);
+    for (size_t i = 0; i < run.size(); ++i)
+    {
+        if (m_fixedPitch > 0.f)
+        {
+            column += run[i].glyph->advance() == 0.f ? 0 : 1;
+            m_prefixAdvances[i + 1] = Typesetter::columnPen(column, m_fixedPitch);
+            continue;
+        }
+
+        auto pen = m_prefixAdvances[i];
+        if (i > 0)
+            pen += run[i].kerning;
+        m_prefixAdvances[i + 1] = pen + run[i].glyph->advance();
+    }
+
+    m_prefixAdvancesValid = true;
+    return m_prefixAdvances;
+}
+
+float GlyphSequence::resolve(
+    const FontFace & fontFace
+,   const std::u32string & string
+,   std::vector<ResolvedGlyph> & glyphRun)
+{
+    glyphRun.resize(string.size());
+
+    const auto fixedAdvance = fontFace.fixedAdvance();
+    auto fixedPitch = fixedAdvance;
+
+    for (size_t i = 0; i < string.size(); ++i)
+    {
+        const auto & glyph = fontFace.glyph(string[i]);
+        glyphRun[i].glyph = &glyph;
+        glyphRun[i].kerning = i > 0 && fixedAdvance == 0.f ? fontFace.kerning(string[i - 1], string[i]) : 0.f;
+        if (!fitsPitch(string[i], glyph, fixedAdvance))
+            fixedPitch = 0.f;
+    }
+    return fixedPitch;
+}
+
 const std::vector<char32_t> & GlyphSequence::chars(
     std::vector<char32_t> & allChars) const
 {
@@ -77,10 +343,11 @@ const std::vector<char32_t> & GlyphSequence::depictableChars(
 {
     depictableChars.reserve(depictableChars.size() + depictableSize());
 
-    for (const auto & c : m_string)
+    const auto & run = glyphRun();
+    for (size_t i = 0; i < run.size(); ++i)
     {
-        if(m_fontFace->depictable(c))
-            depictableChars.push_back(c);
+        if (run[i].glyph->depictable())
+            depictableChars.push_back(m_string[i]);
     }
     return depictableChars;
 }
@@ -157,6 +424,7 @@ FontFace * GlyphSequence::fontFace() const
 void GlyphSequence::setFontFace(FontFace * fontFace)
 {
     m_transformValid = false;
+    m_glyphRunValid = m_glyphRunValid && m_fontFace == fontFace;
     m_fontFace = fontFace;
 }
 
@@ -214,4 +482,80 @@ void GlyphSequence::computeTransform() const
     m_transform = glm::scale(m_transform, glm::vec3(m_fontSize / m_fontFace->size()));
 }
 
+void GlyphSequence::resolveGlyphs() const
+{
+    assert(m_fontFace);
+
+    // the non-const lookup adds missing glyphs as empty ones; glyph addresses remain valid
+    // when further glyphs are added to the font face
+    m_glyphRun.resize(m_string.size());
+    m_depictableSize = 0;
+
+    // fixed pitch font faces have no kerning to look up
+    const auto fixedAdvance = m_fontFace->fixedAdvance();
+    m_fixedPitch = fixedAdvance;
+
+    for (size_t i = 0; i < m_string.size(); ++i)
+    {
+        const auto & glyph = m_fontFace->glyph(m_string[i]);
+        m_glyphRun[i].glyph = &glyph;
+        m_glyphRun[i].kerning = i > 0 && fixedAdvance == 0.f ? m_fontFace->kerning(m_string[i - 1], m_string[i]) : 0.f;
+        if (glyph.depictable())
+            ++m_depictableSize;
+        if (!fitsPitch(m_string[i], glyph, fixedAdvance))
+            m_fixedPitch = 0.f;
+    }
+    m_glyphRunValid = true;
+    m_prefixAdvancesValid = false;
+}
+
+void GlyphSequence::spliceGlyphs(const size_t position, const size_t erased, const size_t inserted)
+{
+    // the string is already edited; a run that is not resolved yet is resolved on use
+    if (!m_glyphRunValid)
+        return;
+
+    m_prefixAdvancesValid = false;
+
+    const auto begin = m_glyphRun.begin() + position;
+    m_depictableSize -= std::count_if(begin, begin + erased, [](const ResolvedGlyph & resolved)
+        { return resolved.glyph->depictable(); });
+
+    m_glyphRun.erase(begin, begin + erased);
+    m_glyphRun.insert(m_glyphRun.begin() + position, inserted, ResolvedGlyph{ nullptr, 0.f });
+
+    // resolve inserted glyphs and the kerning of the glyph following the edit
+    const auto end = std::min(position + inserted + 1, m_string.size());
+    for (auto i = position; i < end; ++i)
+    {
+        if (i < position + inserted)
+        {
+            m_glyphRun[i].glyph = &m_fontFace->glyph(m_string[i]);
+            if (m_glyphRun[i].glyph->depictable())
+                ++m_depictableSize;
+            if (!fitsPitch(m_string[i], *m_glyphRun[i].glyph, m_fixedPitch))
+                m_fixedPitch = 0.f;
+        }
+        m_glyphRun[i].kerning = i > 0 && m_fontFace->fixedAdvance() == 0.f ? m_fontFace->kerning(m_string[i - 1], m_string[i]) : 0.f;
+    }
+}
+
+void GlyphSequence::recordEdit(const size_t position, const size_t erased, const size_t inserted)
+{
+    if (!m_edited)
+    {
+        m_edited = true;
+        m_edit = { position, position + erased, position + inserted };
+        return;
+    }
+
+    // merge with the previous edits: extend the changed range to cover both, where characters
+    // after the previously changed range are shifted equally in both strings
+    const auto end = std::max(m_edit.newEnd, position + erased);
+
+    m_edit.begin = std::min(m_edit.begin, position);
+    m_edit.oldEnd += end - m_edit.newEnd;
+    m_edit.newEnd = end - erased + inserted;
+}
+
 } // namespace gloperate_text
@@ -3,6 +3,7 @@
 
 #include <numeric>
 #include <algorithm>
+#include <limits>
 
 #include <glbinding/gl/enum.h>
 #include <glbinding/gl/boolean.h>
@@ -10,35 +11,35 @@
 #include <openll/GlyphSequence.h>
 #include <openll/Typesetter.h>
 
+#include "parallel_for.h"
+
 
 namespace
 {
 // http://stackoverflow.com/a/17074810 (thanks to Timothy Shields)
 
 template <typename T, typename Compare>
-std::vector<std::size_t> sort_permutation(
+void sort_permutation(
     const std::vector<T> & vec
-,   const Compare & compare)
+,   const Compare & compare
+,   std::vector<std::size_t> & p)
 {
-    std::vector<std::size_t> p(vec.size());
+    p.resize(vec.size());
 
     std::iota(p.begin(), p.end(), 0);
     std::sort(p.begin(), p.end(), [&](std::size_t i, std::size_t j)
         { return compare(vec[i], vec[j]); });
-
-    return p;
 }
 
 template <typename T>
-std::vector<T> apply_permutation(
+void apply_permutation(
     const std::vector<T> & vec
-,   const std::vector<std::size_t> & p)
+,   const std::vector<std::size_t> & p
+,   std::vector<T> & sorted_vec)
 {
-    std::vector<T> sorted_vec(p.size());
+    sorted_vec.resize(p.size());
     std::transform(p.begin(), p.end(), sorted_vec.begin(),
         [&](std::size_t i) { return vec[i]; });
-
-    return sorted_vec;
 }
 
 template <typename Class, typename Type>
@@ -54,7 +55,17 @@ namespace gloperate_text
 {
 
 
+bool GlyphVertexCloud::FontSpaceLayout::matches(const GlyphSequence & sequence) const
+{
+    return fontFace == sequence.fontFace() && wordWrap == sequence.wordWrap() && alignment == sequence.alignment()
+        && (!wordWrap || lineWidth == sequence.lineWidth()) && string == sequence.string();
+}
+
+
 GlyphVertexCloud::GlyphVertexCloud()
+: m_fontSpaceCaching(false)
+, m_parallelTypesetting(false)
+, m_hitTesting(false)
 {
 }
 
@@ -142,26 +153,43 @@ void GlyphVertexCloud::update(const Vertices & vertices)
 
 void GlyphVertexCloud::updateWithSequences(const std::vector<GlyphSequence>& sequences, bool optimized)
 {
-    // get total number of glyphs
-    auto numGlyphs = size_t(0u);
-    for (const auto & sequence : sequences)
-        numGlyphs += sequence.depictableSize();
+    // get offsets and total number of glyphs; depictableSize resolves the glyphs of each
+    // sequence, which may add missing glyphs to the font face, so this is done serially
+    auto & offsets = m_offsets;
+    offsets.assign(sequences.size() + 1, size_t(0u));
+    for (size_t i = 0; i < sequences.size(); ++i)
+        offsets[i + 1] = offsets[i] + sequences[i].depictableSize();
+
+    const auto numGlyphs = offsets.back();
 
     // prepare vertex cloud storage
     m_vertices.resize(numGlyphs);
 
-    if (sequences.empty()) return;
+    if (sequences.empty())
+    {
+        if (m_hitTesting)
+            m_hitTestIndex.build(sequences, *this);
+        return;
+    }
 
     FontFace * font = sequences[0].fontFace();
 
-    auto index = m_vertices.begin();
-    for (const auto & sequence : sequences)
+    const auto numWorkers = m_parallelTypesetting ? numWorkersFor(numGlyphs) : size_t(1u);
+
+    if (m_fontSpaceCaching)
+        typesetWithFontSpaceCache(sequences, offsets, numWorkers);
+    else
     {
-        assert(font == sequence.fontFace());
-        Typesetter::typeset(sequence, index);
-        index += sequence.depictableSize();
+        // each sequence is typeset directly into its slot
+        parallel_for(sequences.size(), numWorkers, [&](const size_t i)
+        {
+            assert(font == sequences[i].fontFace());
+            Typesetter::typeset(sequences[i], m_vertices.data() + offsets[i]);
+        });
     }
 
+    if (m_hitTesting)
+        m_hitTestIndex.update(sequences, *this);
 
     if(optimized)
         optimize(sequences); // optimize and update drawable
@@ -171,23 +199,126 @@ void GlyphVertexCloud::updateWithSequences(const std::vector<GlyphSequence>& seq
     setTexture(font->glyphTexture());
 }
 
+bool GlyphVertexCloud::fontSpaceCaching() const
+{
+    return m_fontSpaceCaching;
+}
+
+void GlyphVertexCloud::setFontSpaceCaching(const bool enable)
+{
+    m_fontSpaceCaching = enable;
+    if (enable)
+        return;
+
+    m_fontSpaceVertices.clear();
+    m_fontSpaceLayouts.clear();
+}
+
+bool GlyphVertexCloud::parallelTypesetting() const
+{
+    return m_parallelTypesetting;
+}
+
+void GlyphVertexCloud::setParallelTypesetting(const bool enable)
+{
+    m_parallelTypesetting = enable;
+}
+
+bool GlyphVertexCloud::hitTesting() const
+{
+    return m_hitTesting;
+}
+
+void GlyphVertexCloud::setHitTesting(const bool enable)
+{
+    m_hitTesting = enable;
+    if (!enable)
+        m_hitTestIndex = HitTestIndex();
+}
+
+const HitTestIndex & GlyphVertexCloud::hitTestIndex() const
+{
+    return m_hitTestIndex;
+}
+
+void GlyphVertexCloud::typesetWithFontSpaceCache(
+    const std::vector<GlyphSequence> & sequences
+,   const std::vector<size_t> & offsets
+,   const size_t numWorkers)
+{
+    // sequences are matched by index, so that only changed sequences are typeset again
+    auto unchanged = sequences.size() == m_fontSpaceLayouts.size();
+    for (size_t i = 0; unchanged && i < sequences.size(); ++i)
+        unchanged = m_fontSpaceLayouts[i].matches(sequences[i]);
+
+    if (!unchanged)
+    {
+        Vertices fontSpaceVertices(m_vertices.size());
+        std::vector<FontSpaceLayout> fontSpaceLayouts;
+        fontSpaceLayouts.reserve(sequences.size());
+
+        // the previous begin of each sequence's glyphs, if these can be reused
+        const auto retypeset = std::numeric_limits<size_t>::max();
+        std::vector<size_t> previousBegins(sequences.size(), retypeset);
+
+        for (size_t i = 0; i < sequences.size(); ++i)
+        {
+            const auto & sequence = sequences[i];
+
+            if (i < m_fontSpaceLayouts.size() && m_fontSpaceLayouts[i].matches(sequence))
+            {
+                previousBegins[i] = m_fontSpaceLayouts[i].begin;
+                fontSpaceLayouts.push_back(std::move(m_fontSpaceLayouts[i]));
+            }
+            else
+                fontSpaceLayouts.push_back({ sequence.string(), sequence.fontFace(), sequence.wordWrap(),
+                    sequence.lineWidth(), sequence.alignment(), 0 });
+
+            fontSpaceLayouts.back().begin = offsets[i];
+        }
+
+        parallel_for(sequences.size(), numWorkers, [&](const size_t i)
+        {
+            const auto begin = fontSpaceVertices.data() + offsets[i];
+            if (previousBegins[i] == retypeset)
+            {
+                Typesetter::typesetFontSpace(sequences[i], begin);
+                return;
+            }
+
+            const auto previous = m_fontSpaceVertices.data() + previousBegins[i];
+            std::copy(previous, previous + (offsets[i + 1] - offsets[i]), begin);
+        });
+
+        m_fontSpaceVertices.swap(fontSpaceVertices);
+        m_fontSpaceLayouts.swap(fontSpaceLayouts);
+    }
+
+    parallel_for(sequences.size(), numWorkers, [&](const size_t i)
+    {
+        const auto begin = m_fontSpaceVertices.data() + offsets[i];
+        const auto end = m_fontSpaceVertices.data() + offsets[i + 1];
+        Typesetter::transform(sequences[i], begin, end, m_vertices.data() + offsets[i]);
+    });
+}
+
 void GlyphVertexCloud::optimize(const std::vector<GlyphSequence> & sequences)
 {
     // L1/texture-cache optimization: sort vertex cloud by glyphs
 
-    // create string associated with all depictable glyphs
-    auto depictableChars = std::vector<char32_t>();
-    auto vertices = m_vertices;
-
+    // create string associated with all depictable glyphs (buffers are kept for reuse)
+    m_optimizeChars.clear();
+    m_optimizeChars.reserve(m_vertices.size());
     for (const auto & sequence : sequences)
-        sequence.depictableChars(depictableChars);
+        sequence.depictableChars(m_optimizeChars);
 
-    assert(vertices.size() == depictableChars.size());
+    assert(m_vertices.size() == m_optimizeChars.size());
 
-    const auto p = sort_permutation(depictableChars,
-        [](const char32_t & a, const char32_t & b) { return a < b; });
+    sort_permutation(m_optimizeChars,
+        [](const char32_t & a, const char32_t & b) { return a < b; }, m_optimizePermutation);
 
-    update(apply_permutation(vertices, p));
+    apply_permutation(m_vertices, m_optimizePermutation, m_optimizedVertices);
+    update(m_optimizedVertices);
 }
 
 
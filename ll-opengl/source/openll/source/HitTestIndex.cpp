@@ -0,0 +1,381 @@
+
+#include <openll/HitTestIndex.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include <glm/common.hpp>
+
+#include <openll/Glyph.h>
+#include <openll/GlyphSequence.h>
+#include <openll/GlyphVertexCloud.h>
+
+
+namespace
+{
+
+// leaf size of the hierarchies, leaves are scanned linearly
+const std::uint32_t leafSize = 4;
+
+using Bounds = std::pair<glm::vec2, glm::vec2>;
+
+Bounds emptyBounds()
+{
+    return { glm::vec2(std::numeric_limits<float>::max()), glm::vec2(std::numeric_limits<float>::lowest()) };
+}
+
+glm::vec2 planar(const glm::vec3 & v)
+{
+    return glm::vec2(v.x, v.y);
+}
+
+bool overlaps(const glm::vec2 & lowerLeft, const glm::vec2 & upperRight
+    , const glm::vec2 & otherLowerLeft, const glm::vec2 & otherUpperRight)
+{
+    return lowerLeft.x <= otherUpperRight.x && otherLowerLeft.x <= upperRight.x
+        && lowerLeft.y <= otherUpperRight.y && otherLowerLeft.y <= upperRight.y;
+}
+
+Bounds quadBounds(const glm::vec2 & origin, const glm::vec2 & tangent, const glm::vec2 & bitangent)
+{
+    return { origin + glm::min(tangent, 0.f) + glm::min(bitangent, 0.f)
+        , origin + glm::max(tangent, 0.f) + glm::max(bitangent, 0.f) };
+}
+
+// whether the quad intersects the rectangle, separated along neither the rectangle's axes
+// nor the normals of the quad's edges
+bool quadOverlaps(const glm::vec2 & origin, const glm::vec2 & tangent, const glm::vec2 & bitangent
+    , const glm::vec2 & lowerLeft, const glm::vec2 & upperRight)
+{
+    const auto bounds = quadBounds(origin, tangent, bitangent);
+    if (!overlaps(bounds.first, bounds.second, lowerLeft, upperRight))
+        return false;
+
+    const auto center = (lowerLeft + upperRight) * 0.5f;
+    const auto halfExtent = (upperRight - lowerLeft) * 0.5f;
+
+    const auto separated = [&](const glm::vec2 & edge, const glm::vec2 & other)
+    {
+        const auto normal = glm::vec2(-edge.y, edge.x);
+        const auto distance = (origin.x - center.x) * normal.x + (origin.y - center.y) * normal.y;
+        const auto reach = other.x * normal.x + other.y * normal.y;
+        const auto radius = halfExtent.x * std::abs(normal.x) + halfExtent.y * std::abs(normal.y);
+
+        return distance + std::min(reach, 0.f) > radius || distance + std::max(reach, 0.f) < -radius;
+    };
+    return !separated(tangent, bitangent) && !separated(bitangent, tangent);
+}
+
+// builds the hierarchy over elements [first, last) at nodes[node], splitting at the median
+// along the longer axis of the elements' centers; children are allocated at next, siblings
+// adjacent and after their parent
+template <typename Node, typename Element, typename ElementBounds>
+void buildHierarchy(std::vector<Node> & nodes, const std::uint32_t node, std::uint32_t & next
+    , Element * elements, const std::uint32_t first, const std::uint32_t last
+    , const ElementBounds & elementBounds)
+{
+    const auto center = [&](const Element & element)
+    {
+        const auto bounds = elementBounds(element);
+        return (bounds.first + bounds.second) * 0.5f;
+    };
+
+    auto bounds = emptyBounds();
+    auto centerBounds = emptyBounds();
+    for (auto i = first; i < last; ++i)
+    {
+        const auto b = elementBounds(elements[i]);
+        bounds = { glm::min(bounds.first, b.first), glm::max(bounds.second, b.second) };
+
+        const auto c = (b.first + b.second) * 0.5f;
+        centerBounds = { glm::min(centerBounds.first, c), glm::max(centerBounds.second, c) };
+    }
+
+    nodes[node].lowerLeft = bounds.first;
+    nodes[node].upperRight = bounds.second;
+
+    if (last - first <= leafSize)
+    {
+        nodes[node].first = first;
+        nodes[node].count = last - first;
+        return;
+    }
+
+    const auto extent = centerBounds.second - centerBounds.first;
+    const auto axis = extent.x >= extent.y ? 0 : 1;
+    const auto median = first + (last - first) / 2;
+    std::nth_element(elements + first, elements + median, elements + last,
+        [&](const Element & a, const Element & b) { return center(a)[axis] < center(b)[axis]; });
+
+    const auto children = next;
+    next += 2;
+    nodes[node].first = children;
+    nodes[node].count = 0;
+
+    buildHierarchy(nodes, children, next, elements, first, median, elementBounds);
+    buildHierarchy(nodes, children + 1, next, elements, median, last, elementBounds);
+}
+
+// visits the leaves of the hierarchy at nodes[root] that intersect the rectangle
+template <typename Node, typename Callback>
+void visitLeaves(const std::vector<Node> & nodes, const std::uint32_t root
+    , const glm::vec2 & lowerLeft, const glm::vec2 & upperRight, Callback callback)
+{
+    // every visited inner node replaces itself by its two children, so the stack is bounded by
+    // the depth of the hierarchy (below 32 levels for median splits of 32 bit indices)
+    std::array<std::uint32_t, 64> stack;
+    auto top = std::size_t(0);
+    stack[top++] = root;
+
+    while (top > 0)
+    {
+        const auto & node = nodes[stack[--top]];
+        if (!overlaps(node.lowerLeft, node.upperRight, lowerLeft, upperRight))
+            continue;
+
+        if (node.count > 0)
+        {
+            callback(node);
+            continue;
+        }
+
+        stack[top++] = node.first;
+        stack[top++] = node.first + 1;
+    }
+}
+
+}
+
+
+namespace gloperate_text
+{
+
+
+HitTestIndex::HitTestIndex()
+: m_offsets(1, size_t(0))
+{
+}
+
+HitTestIndex::~HitTestIndex()
+{
+}
+
+void HitTestIndex::build(
+    const std::vector<GlyphSequence> & sequences
+,   const GlyphVertexCloud & cloud)
+{
+    const auto & vertices = cloud.vertices();
+
+    m_offsets.assign(sequences.size() + 1, size_t(0));
+    for (size_t i = 0; i < sequences.size(); ++i)
+        m_offsets[i + 1] = m_offsets[i] + sequences[i].depictableSize();
+
+    assert(m_offsets.back() == vertices.size());
+    assert(vertices.size() < std::numeric_limits<std::uint32_t>::max() / 2);
+
+    m_items.resize(vertices.size());
+    m_glyphNodes.resize(2 * vertices.size());
+    for (size_t i = 0; i < sequences.size(); ++i)
+        indexSequence(sequences[i], i, cloud);
+
+    m_sequences.clear();
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        if (m_offsets[i + 1] > m_offsets[i])
+            m_sequences.push_back(static_cast<std::uint32_t>(i));
+    }
+
+    m_sequenceNodes.resize(2 * m_sequences.size());
+    if (m_sequences.empty())
+        return;
+
+    auto next = std::uint32_t(1);
+    buildHierarchy(m_sequenceNodes, 0, next, m_sequences.data(), 0, static_cast<std::uint32_t>(m_sequences.size())
+        , [this](const std::uint32_t sequence) { return bounds(sequence); });
+    m_sequenceNodes.resize(next);
+}
+
+void HitTestIndex::update(
+    const std::vector<GlyphSequence> & sequences
+,   const GlyphVertexCloud & cloud)
+{
+    const auto & vertices = cloud.vertices();
+
+    auto rebuild = sequences.size() != size() || vertices.size() != m_items.size();
+    for (size_t i = 0; !rebuild && i < sequences.size(); ++i)
+        rebuild = sequences[i].depictableSize() != m_offsets[i + 1] - m_offsets[i];
+
+    if (rebuild)
+    {
+        build(sequences, cloud);
+        return;
+    }
+
+    const auto moved = [&vertices](const Item & item)
+    {
+        const auto & vertex = vertices[item.vertex];
+        return item.origin.x != vertex.origin.x || item.origin.y != vertex.origin.y
+            || item.tangent.x != vertex.vtan.x || item.tangent.y != vertex.vtan.y
+            || item.bitangent.x != vertex.vbitan.x || item.bitangent.y != vertex.vbitan.y;
+    };
+
+    auto changed = false;
+    for (size_t i = 0; i < sequences.size(); ++i)
+    {
+        if (!std::any_of(m_items.cbegin() + m_offsets[i], m_items.cbegin() + m_offsets[i + 1], moved))
+            continue;
+
+        indexSequence(sequences[i], i, cloud);
+        changed = true;
+    }
+
+    if (changed)
+        refit();
+}
+
+size_t HitTestIndex::size() const
+{
+    return m_offsets.size() - 1;
+}
+
+std::pair<glm::vec2, glm::vec2> HitTestIndex::bounds(const size_t sequence) const
+{
+    assert(sequence < size());
+
+    if (m_offsets[sequence] == m_offsets[sequence + 1])
+        return emptyBounds();
+
+    const auto & root = m_glyphNodes[2 * m_offsets[sequence]];
+    return { root.lowerLeft, root.upperRight };
+}
+
+template <typename Callback>
+void HitTestIndex::visitSequences(
+    const glm::vec2 & lowerLeft
+,   const glm::vec2 & upperRight
+,   Callback callback) const
+{
+    if (m_sequenceNodes.empty())
+        return;
+
+    visitLeaves(m_sequenceNodes, 0, lowerLeft, upperRight, [&](const Node & leaf)
+    {
+        for (auto i = leaf.first; i < leaf.first + leaf.count; ++i)
+        {
+            const auto sequence = m_sequences[i];
+            const auto bounds = this->bounds(sequence);
+            if (overlaps(bounds.first, bounds.second, lowerLeft, upperRight))
+                callback(sequence);
+        }
+    });
+}
+
+void HitTestIndex::glyphsAt(const glm::vec2 & point, std::vector<Hit> & hits) const
+{
+    glyphsWithin(point, point, hits);
+}
+
+void HitTestIndex::glyphsWithin(
+    const glm::vec2 & lowerLeft
+,   const glm::vec2 & upperRight
+,   std::vector<Hit> & hits) const
+{
+    hits.clear();
+
+    visitSequences(lowerLeft, upperRight, [&](const size_t sequence)
+    {
+        const auto root = static_cast<std::uint32_t>(2 * m_offsets[sequence]);
+        visitLeaves(m_glyphNodes, root, lowerLeft, upperRight, [&](const Node & leaf)
+        {
+            for (auto i = leaf.first; i < leaf.first + leaf.count; ++i)
+            {
+                const auto & item = m_items[i];
+                if (quadOverlaps(item.origin, item.tangent, item.bitangent, lowerLeft, upperRight))
+                    hits.push_back({ sequence, item.index });
+            }
+        });
+    });
+}
+
+void HitTestIndex::sequencesAt(const glm::vec2 & point, std::vector<size_t> & sequences) const
+{
+    sequencesWithin(point, point, sequences);
+}
+
+void HitTestIndex::sequencesWithin(
+    const glm::vec2 & lowerLeft
+,   const glm::vec2 & upperRight
+,   std::vector<size_t> & sequences) const
+{
+    sequences.clear();
+    visitSequences(lowerLeft, upperRight, [&sequences](const size_t sequence) { sequences.push_back(sequence); });
+}
+
+void HitTestIndex::indexSequence(
+    const GlyphSequence & sequence
+,   const size_t index
+,   const GlyphVertexCloud & cloud)
+{
+    const auto & vertices = cloud.vertices();
+
+    const auto begin = m_offsets[index];
+    const auto end = m_offsets[index + 1];
+    if (begin == end)
+        return;
+
+    // depictable glyphs are typeset into consecutive vertices
+    const auto & glyphs = sequence.glyphRun();
+    auto item = begin;
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        if (!glyphs[i].glyph->depictable())
+            continue;
+
+        const auto & vertex = vertices[item];
+        m_items[item] = { planar(vertex.origin), planar(vertex.vtan), planar(vertex.vbitan)
+            , static_cast<std::uint32_t>(item), static_cast<std::uint32_t>(i) };
+        ++item;
+    }
+    assert(item == end);
+
+    // a hierarchy over k items takes at most 2k - 1 nodes
+    const auto root = static_cast<std::uint32_t>(2 * begin);
+    auto next = root + 1;
+    buildHierarchy(m_glyphNodes, root, next, m_items.data()
+        , static_cast<std::uint32_t>(begin), static_cast<std::uint32_t>(end)
+        , [](const Item & item) { return quadBounds(item.origin, item.tangent, item.bitangent); });
+}
+
+void HitTestIndex::refit()
+{
+    // children succeed their parents
+    for (auto n = m_sequenceNodes.size(); n-- > 0; )
+    {
+        auto & node = m_sequenceNodes[n];
+
+        auto bounds = emptyBounds();
+        if (node.count > 0)
+        {
+            for (auto i = node.first; i < node.first + node.count; ++i)
+            {
+                const auto b = this->bounds(m_sequences[i]);
+                bounds = { glm::min(bounds.first, b.first), glm::max(bounds.second, b.second) };
+            }
+        }
+        else
+        {
+            const auto & left = m_sequenceNodes[node.first];
+            const auto & right = m_sequenceNodes[node.first + 1];
+            bounds = { glm::min(left.lowerLeft, right.lowerLeft), glm::max(left.upperRight, right.upperRight) };
+        }
+
+        node.lowerLeft = bounds.first;
+        node.upperRight = bounds.second;
+    }
+}
+
+
+} // namespace gloperate_text
@@ -0,0 +1,81 @@
+
+#include <openll/LineIndex.h>
+
+#include <algorithm>
+#include <cassert>
+
+#include <openll/FontFace.h>
+#include <openll/GlyphSequence.h>
+#include <openll/Typesetter.h>
+
+
+namespace gloperate_text
+{
+
+
+LineIndex::LineIndex()
+: m_extent(0.f)
+, m_base(0.f)
+, m_lineHeight(0.f)
+{
+}
+
+LineIndex::LineIndex(const GlyphSequence & sequence)
+: LineIndex()
+{
+    build(sequence);
+}
+
+LineIndex::~LineIndex()
+{
+}
+
+void LineIndex::build(const GlyphSequence & sequence)
+{
+    assert(sequence.fontFace());
+
+    m_base = sequence.fontFace()->base();
+    m_lineHeight = sequence.fontFace()->lineHeight();
+    m_extent = Typesetter::measureLines(sequence, m_lines);
+}
+
+const std::vector<LineMetrics> & LineIndex::lines() const
+{
+    return m_lines;
+}
+
+size_t LineIndex::size() const
+{
+    return m_lines.size();
+}
+
+const glm::vec2 & LineIndex::extent() const
+{
+    return m_extent;
+}
+
+std::pair<size_t, size_t> LineIndex::linesWithin(const float top, const float bottom) const
+{
+    assert(top >= bottom);
+
+    // baselines descend, so lines above the interval precede the ones intersecting it
+    const auto first = std::partition_point(m_lines.cbegin(), m_lines.cend(), [&](const LineMetrics & line)
+        { return line.baseline + m_base - m_lineHeight >= top; });
+    const auto last = std::partition_point(first, m_lines.cend(), [&](const LineMetrics & line)
+        { return line.baseline + m_base > bottom; });
+
+    return { static_cast<size_t>(first - m_lines.cbegin()), static_cast<size_t>(last - m_lines.cbegin()) };
+}
+
+size_t LineIndex::vertexCount(const size_t first, const size_t last) const
+{
+    assert(first <= last && last <= m_lines.size());
+
+    if (first == last)
+        return 0;
+
+    return m_lines[last - 1].vertexEnd - m_lines[first].vertexBegin;
+}
+
+
+} // namespace gloperate_text
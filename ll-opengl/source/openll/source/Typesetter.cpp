@@ -1,5 +1,10 @@
 
 #include <cassert>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 
 #include <openll/Typesetter.h>
 
@@ -10,22 +15,559 @@
 #include <glm/geometric.hpp>
 
 #include <openll/Alignment.h>
+#include <openll/ArcLengthTable.h>
+#include <openll/ExtentCache.h>
 #include <openll/FontFace.h>
 #include <openll/GlyphSequence.h>
+#include <openll/LineMetrics.h>
+
+#include "parallel_for.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OPENLL_TYPESETTER_SSE
+#include <xmmintrin.h>
+#endif
+
+
+namespace
+{
+
+// common delimiters: line feed, space, and , . - / ( ) [ ] < >
+// Note: a bit mask of the (ASCII) delimiters outperforms u32string::find here (tested)
+bool isDelimiter(const char32_t c)
+{
+    static const auto mask0 = (uint64_t(1) << 0x0A) | (uint64_t(1) << ' ') | (uint64_t(1) << ',')
+        | (uint64_t(1) << '.') | (uint64_t(1) << '-') | (uint64_t(1) << '/') | (uint64_t(1) << '(')
+        | (uint64_t(1) << ')') | (uint64_t(1) << '<') | (uint64_t(1) << '>');
+    static const auto mask1 = (uint64_t(1) << ('[' - 64)) | (uint64_t(1) << (']' - 64));
+
+    return c < 64 ? (mask0 >> c) & 1 : c < 128 && (mask1 >> (c - 64)) & 1;
+}
+
+// Decides where lines are fed: at line feeds and, with word wrap, before a word that does
+// not fit into the current line (or before a glyph if the word does not fit into any line).
+// The width of a word is accumulated once, at its first glyph that is not wrapped by itself,
+// so line breaking takes a single pass over the string. For sequences of fixed pitch (see
+// GlyphSequence::fixedPitch), lines are broken by counting columns instead, the pen being at
+// the column's pen (see Typesetter::columnPen); words are as wide as they are long.
+class LineBreaker
+{
+public:
+    LineBreaker(const std::u32string & string, const std::vector<gloperate_text::GlyphSequence::ResolvedGlyph> & glyphs
+        , float pitch, bool wordWrap, float lineWidth, size_t wordEnd = 0)
+    : m_string(string)
+    , m_glyphs(glyphs)
+    , m_pitch(pitch)
+    , m_wordWrap(wordWrap)
+    , m_lineWidth(lineWidth)
+    , m_maxColumns(maxColumns(string, pitch, lineWidth))
+    , m_wordEnd(wordEnd)
+    , m_bracket(0.f, std::numeric_limits<float>::infinity())
+    {
+    }
+
+    LineBreaker(const gloperate_text::GlyphSequence & sequence, bool wordWrap, float lineWidth, size_t wordEnd = 0)
+    : LineBreaker(sequence.string(), sequence.glyphRun(), sequence.fixedPitch(), wordWrap, lineWidth, wordEnd)
+    {
+    }
+
+    // the state to resume line breaking from at a line that begins at index
+    size_t wordEnd(const size_t index) const
+    {
+        return std::max(m_wordEnd, index);
+    }
+
+    // the advance of the glyph at index, without fixed pitch
+    float advance(const size_t index) const
+    {
+        return m_glyphs[index].glyph->advance();
+    }
+
+    // advances pen (and column) past the glyph at index; with fixed pitch, pen is placed at
+    // the column's pen
+    void advance(const size_t index, float & pen, std::ptrdiff_t & column) const
+    {
+        if (m_pitch == 0.f)
+        {
+            pen += advance(index);
+            return;
+        }
+        column += columns(index);
+        pen = gloperate_text::Typesetter::columnPen(column, m_pitch);
+    }
+
+    // with WordWrap and FixedPitch matching the settings of the line breaker; with fixed pitch,
+    // pen is rounded to its column. With Bracket, the line widths that break lines alike are
+    // narrowed by each comparison to the line width (see bracket)
+    template <bool WordWrap, bool FixedPitch, bool Bracket = false>
+    bool feedLine(const size_t index, const float pen)
+    {
+        if (FixedPitch)
+            return feedColumn<WordWrap>(index, static_cast<std::ptrdiff_t>(std::lround(pen / m_pitch)));
+
+        if (m_string[index] == gloperate_text::Typesetter::lineFeed())
+            return true;
+        if (!WordWrap)
+            return false;
+
+        const auto & resolved = m_glyphs[index];
+        const auto advance = resolved.glyph->advance();
+        const auto wrapGlyph = exceeds<Bracket>(pen + advance + resolved.kerning)
+            && (!exceeds<Bracket>(advance) || pen > 0.f) && resolved.glyph->depictable();
+        if (wrapGlyph || index < m_wordEnd)
+            return wrapGlyph;
+
+        // accumulate glyph advances (including kerning) up to the next delimiter
+        auto width = 0.f;
+        for (m_wordEnd = index; m_wordEnd < m_glyphs.size() && !isDelimiter(m_string[m_wordEnd]); ++m_wordEnd)
+        {
+            width += m_glyphs[m_wordEnd].kerning;
+            width += m_glyphs[m_wordEnd].glyph->advance();
+        }
+        return !exceeds<Bracket>(width) && exceeds<Bracket>(pen + width);
+    }
+
+    // the line widths [x, y) at which the lines fed so far with Bracket are broken alike
+    const glm::vec2 & bracket() const
+    {
+        return m_bracket;
+    }
+
+    // with fixed pitch, the line widths [x, y) at which lines are broken alike, i.e., that
+    // hold as many columns
+    glm::vec2 columnBracket() const
+    {
+        // the narrowest line holding the given columns; the quotient of width and pitch is
+        // monotonic, so this is within a few ulps of the column's pen
+        const auto holding = [&](const std::ptrdiff_t columns)
+        {
+            auto width = gloperate_text::Typesetter::columnPen(columns, m_pitch);
+            while (width > 0.f && maxColumns(m_string, m_pitch, std::nextafter(width, 0.f)) >= columns)
+                width = std::nextafter(width, 0.f);
+            while (maxColumns(m_string, m_pitch, width) < columns)
+                width = std::nextafter(width, std::numeric_limits<float>::infinity());
+            return width;
+        };
+
+        const auto size = static_cast<std::ptrdiff_t>(m_string.size());
+        return glm::vec2(m_maxColumns > 0 ? holding(m_maxColumns) : 0.f
+            , m_maxColumns < size ? holding(m_maxColumns + 1) : std::numeric_limits<float>::infinity());
+    }
+
+    // feedLine for fixed pitch, with the pen at the given column
+    template <bool WordWrap>
+    bool feedColumn(const size_t index, const std::ptrdiff_t column)
+    {
+        if (m_string[index] == gloperate_text::Typesetter::lineFeed())
+            return true;
+        if (!WordWrap)
+            return false;
+
+        const auto wrapGlyph = column + 1 > m_maxColumns
+            && (m_maxColumns >= 1 || column > 0) && m_glyphs[index].glyph->depictable();
+        if (wrapGlyph || index < m_wordEnd)
+            return wrapGlyph;
+
+        // the next delimiter ends the word, so words hold no line feeds (the only glyphs that may
+        // take no column)
+        auto wordEnd = index;
+        while (wordEnd < m_string.size() && !isDelimiter(m_string[wordEnd]))
+            ++wordEnd;
+        m_wordEnd = wordEnd;
+
+        const auto length = static_cast<std::ptrdiff_t>(wordEnd - index);
+        return length <= m_maxColumns && column + length > m_maxColumns;
+    }
+
+    // the columns of the glyph at index, with fixed pitch: glyphs of fixed pitch take one,
+    // line feeds of zero advance none
+    std::ptrdiff_t columns(const size_t index) const
+    {
+        return m_glyphs[index].glyph->advance() == 0.f ? 0 : 1;
+    }
+
+    bool feedLine(const size_t index, const float pen)
+    {
+        if (!m_wordWrap)
+            return feedLine<false, false>(index, pen);
+        return m_pitch == 0.f ? feedLine<true, false>(index, pen) : feedLine<true, true>(index, pen);
+    }
+
+    // reverts the advance of not depictable glyphs preceding a line feed, with index being the
+    // line's last glyph, without fixed pitch
+    void revert(size_t index, float & pen) const
+    {
+        while (index > 0 && !m_glyphs[index].glyph->depictable())
+            pen -= advance(index--);
+    }
+
+    // revert with pen (and column) as advanced by advance
+    void revert(const size_t index, float & pen, std::ptrdiff_t & column) const
+    {
+        if (m_pitch == 0.f)
+        {
+            revert(index, pen);
+            return;
+        }
+        revertColumns(index, column);
+        pen = gloperate_text::Typesetter::columnPen(column, m_pitch);
+    }
+
+    // revert for fixed pitch (as revert, this may pass the line's begin)
+    void revertColumns(size_t index, std::ptrdiff_t & column) const
+    {
+        while (index > 0 && !m_glyphs[index].glyph->depictable())
+            column -= columns(index--);
+    }
+
+protected:
+    template <bool Bracket>
+    bool exceeds(const float width)
+    {
+        const auto exceeding = width > m_lineWidth;
+        if (Bracket && exceeding)
+            m_bracket.y = std::min(m_bracket.y, width);
+        else if (Bracket)
+            m_bracket.x = std::max(m_bracket.x, width);
+        return exceeding;
+    }
+
+    // no line holds more glyphs than the string, which bounds arbitrarily wide lines
+    static std::ptrdiff_t maxColumns(const std::u32string & string, const float pitch, const float lineWidth)
+    {
+        if (pitch <= 0.f)
+            return 0;
+        const auto columns = std::floor(lineWidth / pitch);
+        return columns < static_cast<float>(string.size()) ? static_cast<std::ptrdiff_t>(columns)
+            : static_cast<std::ptrdiff_t>(string.size());
+    }
+
+protected:
+    const std::u32string & m_string;
+    const std::vector<gloperate_text::GlyphSequence::ResolvedGlyph> & m_glyphs;
+    float m_pitch;
+    bool m_wordWrap;
+    float m_lineWidth;
+    std::ptrdiff_t m_maxColumns; // with fixed pitch, the number of glyphs fitting into a line
+    size_t m_wordEnd;            // the word width is known up to here
+    glm::vec2 m_bracket;         // line widths [x, y) consistent with the comparisons so far
+};
+
+#ifdef OPENLL_TYPESETTER_SSE
+
+// transform * vec4(x, y, z, 1) with lanes holding the result's components, summed in the
+// same order as glm's mat4 * vec4, i.e., (c0 * x + c1 * y) + (c2 * z + c3 * 1)
+inline __m128 transformPoint(const __m128 * columns, const float x, const float y, const float z)
+{
+    const auto add0 = _mm_add_ps(_mm_mul_ps(columns[0], _mm_set1_ps(x)), _mm_mul_ps(columns[1], _mm_set1_ps(y)));
+    const auto add1 = _mm_add_ps(_mm_mul_ps(columns[2], _mm_set1_ps(z)), columns[3]);
+    return _mm_add_ps(add0, add1);
+}
+
+inline void store(const __m128 & value, glm::vec3 & vector)
+{
+    _mm_storel_pi(reinterpret_cast<__m64 *>(&vector.x), value);
+    _mm_store_ss(&vector.z, _mm_movehl_ps(value, value));
+}
+
+// transforms the quad at origin x, y, z into destination's origin and axes; the quad is read
+// completely before destination is written
+inline void transformQuad(const __m128 * columns, const float x, const float y, const float z
+    , const glm::vec3 & vtan, const glm::vec3 & vbitan, gloperate_text::GlyphVertexCloud::Vertex * destination)
+{
+    const auto ll = transformPoint(columns, x, y, z);
+    const auto lr = transformPoint(columns, x + vtan.x, y + vtan.y, z + vtan.z);
+    const auto ul = transformPoint(columns, x + vbitan.x, y + vbitan.y, z + vbitan.z);
+
+    store(ll, destination->origin);
+    store(_mm_sub_ps(lr, ll), destination->vtan);
+    store(_mm_sub_ps(ul, ll), destination->vbitan);
+}
+
+#endif
+
+}
 
 
 namespace gloperate_text
 {
 
+ExtentCache * Typesetter::s_extentCache = nullptr;
+
 const char32_t & Typesetter::lineFeed()
 {
     static const auto LF = static_cast<char32_t>('\x0A');
     return LF;
 }
 
+float Typesetter::columnPen(const std::ptrdiff_t column, const float pitch)
+{
+    return static_cast<float>(column) * pitch;
+}
+
 glm::vec2 Typesetter::extent(const GlyphSequence & sequence)
 {
-    return typeset(sequence, GlyphVertexCloud::Vertices::iterator(), true);
+    return extent_transform(sequence, typeset_measure(sequence, sequence.wordWrap() ? sequence.lineWidth() : -1.f));
+}
+
+std::vector<glm::vec2> Typesetter::extents(
+    const GlyphSequence & sequence
+,   const std::vector<float> & lineWidths)
+{
+    const auto & fontFace = *sequence.fontFace();
+    const auto size = fontFace.size();
+    const auto ownWidth = sequence.wordWrap() ? sequence.lineWidth() : -1.f;
+
+    std::vector<glm::vec2> result(lineWidths.size(), glm::vec2(0.f));
+    std::vector<float> widths;
+    std::vector<size_t> indices;
+
+    // line widths are scaled as by GlyphSequence::lineWidth; the ones not cached are measured
+    for (size_t i = 0; i < lineWidths.size(); ++i)
+    {
+        const auto width = lineWidths[i] < 0.f ? ownWidth : glm::max(lineWidths[i] * size / sequence.fontSize(), 0.f);
+        if (s_extentCache && s_extentCache->find(sequence.string(), &fontFace, width, result[i]))
+            continue;
+
+        widths.push_back(width);
+        indices.push_back(i);
+    }
+
+    if (!widths.empty())
+    {
+        std::vector<glm::vec2> measured;
+        if (sequence.fixedPitch() > 0.f)
+            typeset_measure_widths<true>(fontFace, sequence.string(), sequence.glyphRun(), sequence.fixedPitch(), widths, measured);
+        else
+            typeset_measure_widths<false>(fontFace, sequence.string(), sequence.glyphRun(), sequence.fixedPitch(), widths, measured);
+
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            result[indices[i]] = measured[i];
+            if (s_extentCache)
+                s_extentCache->insert(sequence.string(), &fontFace, widths[i], measured[i]);
+        }
+    }
+
+    for (auto & extent : result)
+        extent = extent_transform(sequence, extent);
+    return result;
+}
+
+std::vector<glm::vec2> Typesetter::extents(
+    const FontFace & fontFace
+,   const float fontSize
+,   const std::vector<std::u32string> & strings
+,   const float lineWidth
+,   std::vector<std::vector<float>> * lineWidths)
+{
+    // line width and extents are scaled as by GlyphSequence::lineWidth and extent
+    const auto scale = fontSize / fontFace.size();
+    const auto width = lineWidth < 0.f ? -1.f : glm::max(lineWidth * fontFace.size() / fontSize, 0.f);
+
+    std::vector<glm::vec2> result(strings.size());
+    if (lineWidths)
+        lineWidths->resize(strings.size());
+
+    auto numGlyphs = size_t(0);
+    for (const auto & string : strings)
+        numGlyphs += string.size();
+
+    // blocks of strings share a glyph run
+    const auto blockSize = size_t(64);
+    const auto numBlocks = (strings.size() + blockSize - 1) / blockSize;
+
+    parallel_for(numBlocks, numWorkersFor(numGlyphs), [&](const size_t block)
+    {
+        std::vector<GlyphSequence::ResolvedGlyph> glyphRun;
+
+        for (auto i = block * blockSize; i < std::min((block + 1) * blockSize, strings.size()); ++i)
+        {
+            auto extent = glm::vec2(0.f);
+            if (lineWidths || !s_extentCache || !s_extentCache->find(strings[i], &fontFace, width, extent))
+            {
+                const auto pitch = GlyphSequence::resolve(fontFace, strings[i], glyphRun);
+                const auto lines = lineWidths ? &(*lineWidths)[i] : nullptr;
+
+                extent = typeset_measure(fontFace, strings[i], glyphRun, pitch, width, lines);
+                if (s_extentCache)
+                    s_extentCache->insert(strings[i], &fontFace, width, extent);
+
+                if (lines)
+                {
+                    for (auto & line : *lines)
+                        line *= scale;
+                }
+            }
+            result[i] = extent * scale;
+        }
+    });
+
+    return result;
+}
+
+float Typesetter::fitFontSize(
+    GlyphSequence & sequence
+,   const glm::vec2 & extent)
+{
+    assert(extent.x > 0.f && extent.y > 0.f);
+
+    const auto & fontFace = *sequence.fontFace();
+    const auto & string = sequence.string();
+    const auto & glyphs = sequence.glyphRun();
+    const auto fontSize = sequence.fontSize();
+    const auto wordWrap = sequence.wordWrap();
+
+    if (glyphs.empty())
+        return fontSize;
+
+    // transformed extents scale linearly with the font size (by the additional transform)
+    const auto perSize = extent_transform(sequence, glm::vec2(1.f)) / fontSize;
+    const auto widthFitting = [&](const glm::vec2 & e) { return extent.x / (e.x * perSize.x); };
+    const auto heightFitting = [&](const glm::vec2 & e) { return extent.y / (e.y * perSize.y); };
+
+    // whether the sequence fits at the given size, as measured by extent
+    const auto fits = [&](const float size)
+    {
+        sequence.setFontSize(size);
+        const auto e = extent_transform(sequence, typeset_measure(fontFace, string, glyphs, sequence.fixedPitch()
+            , wordWrap ? sequence.lineWidth() : -1.f, nullptr));
+        return e.x <= extent.x && e.y <= extent.y;
+    };
+
+    // sizes solved for are off by rounding only, so they are corrected by a few ulps at most
+    const auto maxUlps = 8;
+    // the searches below bisect over brackets of font sizes, each step taking a measurement pass
+    const auto maxSteps = 32;
+
+    // the largest size fitting among size and the few below it (but above floor), 0 if none fits
+    const auto fitBelow = [&](float size, const float floor)
+    {
+        for (auto ulps = 0; ulps < maxUlps && size > floor; ++ulps, size = std::nextafter(size, 0.f))
+        {
+            if (fits(size))
+                return size;
+        }
+        return 0.f;
+    };
+
+    // without word wrap, the extent scales linearly
+    auto fitted = 0.f;
+    if (!wordWrap)
+    {
+        const auto e = typeset_measure(fontFace, string, glyphs, sequence.fixedPitch(), -1.f, nullptr);
+        fitted = fitBelow(glm::min(widthFitting(e), heightFitting(e)), 0.f);
+
+        sequence.setFontSize(fitted > 0.f ? fitted : fontSize);
+        return fitted;
+    }
+
+    // wrapped lines are broken alike within brackets of line widths, which are brackets of font
+    // sizes (bottom, top]: the line width at the font size decreases with the font size
+    const auto lineWidthAt = [&](const float size)
+    {
+        sequence.setFontSize(size);
+        return sequence.lineWidth();
+    };
+
+    // the largest font size at which lines are at least the given line width wide
+    const auto sizeAt = [&](const float lineWidth)
+    {
+        if (lineWidth <= 0.f)
+            return std::numeric_limits<float>::infinity();
+        if (std::isinf(lineWidth) || lineWidthAt(fontSize) <= 0.f)
+            return 0.f;
+
+        const auto infinity = std::numeric_limits<float>::infinity();
+        auto size = fontSize * lineWidthAt(fontSize) / lineWidth;
+        for (auto ulps = 0; ulps < maxUlps && size > 0.f && lineWidthAt(size) < lineWidth; ++ulps)
+            size = std::nextafter(size, 0.f);
+        for (auto ulps = 0; ulps < maxUlps && !std::isinf(size) && lineWidthAt(std::nextafter(size, infinity)) >= lineWidth; ++ulps)
+            size = std::nextafter(size, infinity);
+        return size;
+    };
+
+    auto bottom = 0.f;
+    auto top = 0.f;
+    const auto measure = [&](const float size)
+    {
+        auto lineWidths = glm::vec2(0.f);
+        const auto e = typeset_measure_bracket(fontFace, string, glyphs, sequence.fixedPitch(), lineWidthAt(size), lineWidths);
+        bottom = sizeAt(lineWidths.y);
+        top = sizeAt(lineWidths.x);
+        return e;
+    };
+
+    // larger sizes break at least as many lines, so the sizes fitting vertically are bounded
+    // by the largest one: it is bracketed between the top of a bracket fitting vertically and
+    // the bottom of one that does not; within a bracket, the height scales linearly
+    const auto unwrapped = typeset_measure(fontFace, string, glyphs, sequence.fixedPitch(), -1.f, nullptr);
+    auto lower = 0.f;
+    auto upper = std::numeric_limits<float>::infinity();
+    auto size = heightFitting(unwrapped);
+    auto bisect = false;
+
+    for (auto step = 0; step < maxSteps && lower < upper; ++step)
+    {
+        const auto height = heightFitting(measure(size));
+        if (height > bottom && height <= top)
+        {
+            lower = upper = height;
+            break;
+        }
+
+        if (height > top)
+            lower = top;
+        else
+            upper = bottom;
+
+        // the height limit of the last bracket is tried first, then the bracket is bisected
+        size = !bisect && height > lower && height < upper ? height
+            : std::isinf(upper) ? lower * 2.f : lower + (upper - lower) * 0.5f;
+        if (size <= lower)
+            size = upper;
+        bisect = !bisect;
+    }
+
+    // sizes up to lower fit vertically; within a bracket, the width scales linearly, so the
+    // bracket's largest size fitting horizontally is solved for. Brackets above one that fits
+    // are searched next, and below one that does not: lines are broken where they would exceed
+    // the line width, so the width hardly ever fits at a size but not at a smaller one (only if
+    // extent is narrower than the line width, and then a smaller fitting size may be returned)
+    auto floor = 0.f;
+    auto ceiling = lower;
+    size = ceiling;
+    for (auto step = 0; step < maxSteps && floor < ceiling; ++step)
+    {
+        const auto e = measure(size);
+        const auto limit = glm::min(glm::min(top, ceiling), widthFitting(e));
+        const auto candidate = limit > glm::max(bottom, floor) ? fitBelow(limit, glm::max(bottom, floor)) : 0.f;
+
+        if (candidate > 0.f)
+        {
+            fitted = candidate;
+            floor = top;
+        }
+        else
+            ceiling = glm::max(bottom, floor);
+
+        size = floor + (ceiling - floor) * 0.5f;
+        if (size <= floor)
+            size = ceiling;
+    }
+
+    sequence.setFontSize(fitted > 0.f ? fitted : fontSize);
+    return fitted;
+}
+
+void Typesetter::setExtentCache(ExtentCache * cache)
+{
+    s_extentCache = cache;
+}
+
+ExtentCache * Typesetter::extentCache()
+{
+    return s_extentCache;
 }
 
 std::pair<glm::vec2, glm::vec2> Typesetter::rectangle(
@@ -84,241 +626,1161 @@ glm::vec2 Typesetter::typeset(
 ,   const GlyphVertexCloud::Vertices::iterator & begin
 ,   bool dryrun)
 {
-    //const auto & padding = fontFace.glyphTexturePadding();
-    auto & fontFace = *sequence.fontFace();
+    return typeset(sequence, dryrun || sequence.depictableSize() == 0 ? nullptr : &*begin, dryrun);
+}
+
+glm::vec2 Typesetter::typeset(
+    const GlyphSequence & sequence
+,   GlyphVertexCloud::Vertex * begin
+,   bool dryrun)
+{
+    return extent_transform(sequence, typeset_fontspace(sequence, begin, dryrun, true, nullptr));
+}
+
+glm::vec2 Typesetter::typeset(
+    const GlyphSequence & sequence
+,   const GlyphVertexCloud::Vertices::iterator & begin
+,   std::vector<LineMetrics> & lines)
+{
+    return typeset(sequence, sequence.depictableSize() == 0 ? nullptr : &*begin, lines);
+}
+
+glm::vec2 Typesetter::typeset(
+    const GlyphSequence & sequence
+,   GlyphVertexCloud::Vertex * begin
+,   std::vector<LineMetrics> & lines)
+{
+    return extent_transform(sequence, typeset_fontspace(sequence, begin, false, true, &lines));
+}
+
+glm::vec2 Typesetter::typesetFontSpace(
+    const GlyphSequence & sequence
+,   const GlyphVertexCloud::Vertices::iterator & begin)
+{
+    return typesetFontSpace(sequence, sequence.depictableSize() == 0 ? nullptr : &*begin);
+}
+
+glm::vec2 Typesetter::typesetFontSpace(
+    const GlyphSequence & sequence
+,   GlyphVertexCloud::Vertex * begin)
+{
+    return typeset_fontspace(sequence, begin, false, false, nullptr);
+}
+
+void Typesetter::transform(
+    const GlyphSequence & sequence
+,   const GlyphVertexCloud::Vertices::const_iterator & begin
+,   const GlyphVertexCloud::Vertices::const_iterator & end
+,   const GlyphVertexCloud::Vertices::iterator & destination)
+{
+    if (begin == end)
+        return;
+
+    transform(sequence, &*begin, &*begin + (end - begin), &*destination);
+}
+
+void Typesetter::transform(
+    const GlyphSequence & sequence
+,   const GlyphVertexCloud::Vertex * begin
+,   const GlyphVertexCloud::Vertex * end
+,   GlyphVertexCloud::Vertex * destination)
+{
+    // glyphs are already aligned
+    const auto offset = glm::vec2(-0.f, anchor_offset(sequence));
+    vertex_transform(sequence.transform(), offset, sequence.fontColor(), sequence.superSampling(), begin, end, destination);
+}
+
+glm::vec2 Typesetter::typeset_fontspace(
+    const GlyphSequence & sequence
+,   GlyphVertexCloud::Vertex * begin
+,   bool dryrun
+,   bool transform
+,   std::vector<LineMetrics> * lines)
+{
+    // a kernel specialised for the sequence's settings is selected once, so that its per
+    // glyph loop does not branch on these
+    const auto fixedPitch = sequence.fixedPitch() > 0.f;
+    if (sequence.wordWrap())
+        return fixedPitch ? typeset_select<true, true>(sequence, begin, dryrun, transform, lines)
+            : typeset_select<true, false>(sequence, begin, dryrun, transform, lines);
+
+    return fixedPitch ? typeset_select<false, true>(sequence, begin, dryrun, transform, lines)
+        : typeset_select<false, false>(sequence, begin, dryrun, transform, lines);
+}
+
+template <bool WordWrap, bool FixedPitch>
+glm::vec2 Typesetter::typeset_select(
+    const GlyphSequence & sequence
+,   GlyphVertexCloud::Vertex * begin
+,   bool dryrun
+,   bool transform
+,   std::vector<LineMetrics> * lines)
+{
+    // a dry run only measures the lines
+    if (dryrun)
+        return typeset_measure_kernel<WordWrap, FixedPitch>(*sequence.fontFace(), sequence.string()
+            , sequence.glyphRun(), sequence.fixedPitch(), sequence.lineWidth(), nullptr);
+
+    switch (sequence.alignment())
+    {
+    case Alignment::Centered:
+        return transform ? typeset_kernel<WordWrap, FixedPitch, true, Alignment::Centered>(sequence, begin, lines)
+            : typeset_kernel<WordWrap, FixedPitch, false, Alignment::Centered>(sequence, begin, lines);
+    case Alignment::RightAligned:
+        return transform ? typeset_kernel<WordWrap, FixedPitch, true, Alignment::RightAligned>(sequence, begin, lines)
+            : typeset_kernel<WordWrap, FixedPitch, false, Alignment::RightAligned>(sequence, begin, lines);
+    case Alignment::LeftAligned:
+    default:
+        return transform ? typeset_kernel<WordWrap, FixedPitch, true, Alignment::LeftAligned>(sequence, begin, lines)
+            : typeset_kernel<WordWrap, FixedPitch, false, Alignment::LeftAligned>(sequence, begin, lines);
+    }
+}
+
+template <bool WordWrap, bool FixedPitch, bool Transform, Alignment Align>
+glm::vec2 Typesetter::typeset_kernel(
+    const GlyphSequence & sequence
+,   GlyphVertexCloud::Vertex * begin
+,   std::vector<LineMetrics> * lines)
+{
+    if (FixedPitch)
+        return typeset_fixed_kernel<WordWrap, Transform, Align>(sequence, begin, lines);
+
+    const auto & fontFace = *sequence.fontFace();
+    const auto offsetY = anchor_offset(sequence);
+
+    // the line being typeset, recorded once finished if lines are requested
+    auto line = LineMetrics{ 0, 0, 0, 0, 0.f, 0.f, 0.f, 0 };
+    if (lines)
+        lines->clear();
+
+    // aligns the glyphs of a line and, if requested, applies line anchor and transform
+    // within the same pass over its vertices
+    const auto finishLine = [&](const float penX, GlyphVertexCloud::Vertex * lineBegin
+        , GlyphVertexCloud::Vertex * lineEnd, const size_t end)
+    {
+        const auto offset = glm::vec2(align_offset(penX, Align), offsetY);
+        if (lines)
+        {
+            line.end = end;
+            line.vertexBegin = static_cast<size_t>(lineBegin - begin);
+            line.vertexEnd = static_cast<size_t>(lineEnd - begin);
+            line.width = penX;
+            line.offset = offset.x;
+            lines->push_back(line);
+        }
+
+        if (Transform)
+            vertex_transform(sequence.transform(), offset, sequence.fontColor(), sequence.superSampling()
+                , lineBegin, lineEnd, lineBegin);
+        else if (Align != Alignment::LeftAligned)
+        {
+            // origin is expected to be in 'font face space' (not transformed)
+            for (auto v = lineBegin; v != lineEnd; ++v)
+                v->origin.x += offset.x;
+        }
+    };
 
     auto pen = glm::vec2(0.f);
     auto vertex = begin;
     auto extent = glm::vec2(0.f);
 
-    const auto iBegin = sequence.string().cbegin();
-    const auto iEnd = sequence.string().cend();
-
-    // iterator used to reduce the number of wordwrap forward passes
-    auto safe_forward = iBegin;
+    const auto & glyphs = sequence.glyphRun();
+    LineBreaker lineBreaker(sequence, WordWrap, sequence.lineWidth());
 
-    auto feedLine = false;
     auto feedVertex = vertex;
 
-    for (auto i = iBegin; i != iEnd; ++i)
+    for (size_t i = 0; i < glyphs.size(); ++i)
     {
-        const auto & glyph = fontFace.glyph(*i);
+        const auto & glyph = *glyphs[i].glyph;
 
         // handle line feeds as well as word wrap for next word (or
         // next glyph if word width exceeds the max line width)
-        feedLine = *i == lineFeed() || (sequence.wordWrap() &&
-            typeset_wordwrap(sequence, pen, glyph, i, safe_forward));
-
-        if (feedLine)
+        if (lineBreaker.feedLine<WordWrap, false>(i, pen.x))
         {
-            assert(i != iBegin);
-            typeset_extent(fontFace, i - 1, iBegin, pen, extent);
+            assert(i > 0);
+            lineBreaker.revert(i - 1, pen.x);
+            typeset_extent(fontFace, pen, extent);
 
             // handle alignment (when line feed occurs)
-            if (!dryrun)
-                typeset_align(pen, sequence.alignment(), feedVertex, vertex);
+            finishLine(pen.x, feedVertex, vertex, i);
 
             pen.x = 0.f;
             pen.y -= fontFace.lineHeight();
 
-            feedLine = false;
             feedVertex = vertex;
+            if (lines)
+                line = LineMetrics{ i, i, 0, 0, pen.y, 0.f, 0.f, lineBreaker.wordEnd(i) };
         }
-        else if (i != iBegin) // apply kerning
-            pen.x += fontFace.kerning(*(i - 1), *i);
+        else if (i > 0) // apply kerning
+            pen.x += glyphs[i].kerning;
 
         // typeset glyphs in vertex cloud (only if renderable)
-        if (!dryrun && glyph.depictable())
+        if (glyph.depictable())
             typeset_glyph(fontFace, pen, glyph, vertex++);
 
         pen.x += glyph.advance();
 
-        if (i + 1 == iEnd) // handle alignment (when last line of sequence is processed)
+        if (i + 1 == glyphs.size()) // handle alignment (when last line of sequence is processed)
         {
-            typeset_extent(fontFace, i, iBegin, pen, extent);
+            lineBreaker.revert(i, pen.x);
+            typeset_extent(fontFace, pen, extent);
 
-            if (!dryrun)
-                typeset_align(pen, sequence.alignment(), feedVertex, vertex);
+            finishLine(pen.x, feedVertex, vertex, glyphs.size());
         }
     }
 
-    if (!dryrun)
-    {
-        anchor_transform(sequence, begin, vertex);
-        vertex_transform(sequence.transform(), sequence.fontColor(), sequence.superSampling(), begin, vertex);
-    }
-
-    return extent_transform(sequence, extent);
+    return extent;
 }
 
-inline bool Typesetter::typeset_wordwrap(
+template <bool WordWrap, bool Transform, Alignment Align>
+glm::vec2 Typesetter::typeset_fixed_kernel(
     const GlyphSequence & sequence
-,   const glm::vec2 & pen
-,   const Glyph & glyph
-,   const std::u32string::const_iterator & index
-,   std::u32string::const_iterator & safe_forward)
+,   GlyphVertexCloud::Vertex * begin
+,   std::vector<LineMetrics> * lines)
 {
-    assert(sequence.wordWrap());
+    const auto & fontFace = *sequence.fontFace();
+    const auto & string = sequence.string();
+    const auto & glyphs = sequence.glyphRun();
+    const auto pitch = sequence.fixedPitch();
+    const auto offsetY = anchor_offset(sequence);
+    const auto quads = fontFace.asciiQuads();
+    const auto LF = lineFeed();
 
-    const auto lineWidth = sequence.lineWidth();
-    auto width_forward = 0.f;
+#ifdef OPENLL_TYPESETTER_SSE
+    const auto & transform = sequence.transform();
+    const __m128 columns[4] = { _mm_loadu_ps(&transform[0][0]), _mm_loadu_ps(&transform[1][0])
+        , _mm_loadu_ps(&transform[2][0]), _mm_loadu_ps(&transform[3][0]) };
+    const auto fontColor = sequence.fontColor();
+    const auto superSampling = static_cast<GLuint>(sequence.superSampling());
+    const auto transformed = Transform; // glyphs are transformed as they are placed
+#else
+    const auto transformed = false; // lines are transformed once placed
+#endif
 
-    const auto pen_glyph = pen.x + glyph.advance()
-        + (index != sequence.string().cbegin() ? sequence.fontFace()->kerning(*(index - 1), *index) : 0.f);
+    // places a line's glyphs at their columns' pens as typeset_glyph does, aligned and, if
+    // requested, with line anchor and transform applied by the arithmetic of vertex_transform;
+    // glyphs other than line feeds of zero advance take a column each
+    const auto placeLine = [&](const size_t lineBegin, const size_t lineEnd, const float baseline
+        , const glm::vec2 & offset, GlyphVertexCloud::Vertex * vertex)
+    {
+        const auto lineVertexBegin = vertex;
+        auto column = std::ptrdiff_t(0);
 
-    const auto wrap_glyph = glyph.depictable() && pen_glyph > lineWidth
-        && (glyph.advance() <= lineWidth || pen.x > 0.f);
+        for (auto i = lineBegin; i < lineEnd; ++i)
+        {
+            const auto c = string[i];
+            if (c >= 128 && glyphs[i].glyph->depictable())
+            {
+                typeset_glyph(fontFace, glm::vec2(columnPen(column, pitch), baseline), *glyphs[i].glyph, vertex);
+                if (transformed)
+                    vertex_transform(sequence.transform(), offset, sequence.fontColor(), sequence.superSampling()
+                        , vertex, vertex + 1, vertex);
+                else if (!Transform && Align != Alignment::LeftAligned)
+                    vertex->origin.x += offset.x;
+                ++vertex;
+            }
+            else if (c < 128 && quads[c].depictable)
+            {
+                const auto & quad = quads[c];
+                const auto x = columnPen(column, pitch) + quad.rect.x;
+                const auto y = baseline + quad.rect.y;
+                const auto vtan = glm::vec3(quad.rect.z, 0.f, 0.f);
+                const auto vbitan = glm::vec3(0.f, quad.rect.w, 0.f);
 
-    auto wrap_forward = false;
-    if (!wrap_glyph && index >= safe_forward)
-    {
-        safe_forward = typeset_forward(sequence, index, width_forward);
-        wrap_forward = width_forward <= lineWidth && (pen.x + width_forward) > lineWidth;
-    }
+                vertex->uvRect = quad.uvRect;
+#ifdef OPENLL_TYPESETTER_SSE
+                if (transformed)
+                {
+                    transformQuad(columns, x + offset.x, y + offset.y, 0.f, vtan, vbitan, vertex);
+                    vertex->fontColor = fontColor;
+                    vertex->superSampling = superSampling;
+                }
+                else
+#endif
+                {
+                    vertex->origin = glm::vec3(!Transform && Align != Alignment::LeftAligned ? x + offset.x : x, y, 0.f);
+                    vertex->vtan = vtan;
+                    vertex->vbitan = vbitan;
+                }
+                ++vertex;
+            }
 
-    return wrap_forward || wrap_glyph;
-}
+            if (c != LF || glyphs[i].glyph->advance() != 0.f)
+                ++column;
+        }
 
-inline std::u32string::const_iterator Typesetter::typeset_forward(
-    const GlyphSequence & sequence
-,   const std::u32string::const_iterator & begin
-,   float & width)
-{
-    // setup common delimiters
-    // Note: u32string::find outperforms set::count here (tested)
+        if (Transform && !transformed)
+        {
+            vertex_transform(sequence.transform(), offset, sequence.fontColor(), sequence.superSampling()
+                , lineVertexBegin, vertex, lineVertexBegin);
+        }
+        return vertex;
+    };
 
-	static const auto delimiters = std::u32string({ '\x0A', ' ', ',', '.', '-', '/', '(', ')', '[', ']', '<', '>' });
+    LineBreaker lineBreaker(sequence, WordWrap, sequence.lineWidth());
 
-    const auto iBegin = sequence.string().cbegin();
-    const auto iEnd = sequence.string().cend();
+    auto extent = glm::vec2(0.f);
+    auto vertex = begin;
+    auto baseline = 0.f;
+    auto lineBegin = size_t(0);
+    auto column = std::ptrdiff_t(0);
+    auto wordEnd = size_t(0);
 
-    width = 0.f; // reset the width
+    if (lines)
+        lines->clear();
 
-    // accumulate glyph advances (including kerning) up to the next
-    // delimiter occurrence starting at begin of the string.
-    auto i = begin;
-    while (i != iEnd && delimiters.find(*i) == delimiters.npos)
+    // measures the line, then places its glyphs
+    const auto finishLine = [&](const size_t end)
     {
-        if (i != iBegin)
-            width += sequence.fontFace()->kerning(*(i - 1), *i);
+        lineBreaker.revertColumns(end - 1, column);
+        const auto width = columnPen(column, pitch);
+        const auto offset = glm::vec2(align_offset(width, Align), offsetY);
+        typeset_extent(fontFace, glm::vec2(width, baseline), extent);
 
-        width += sequence.fontFace()->glyph(*i++).advance();
-    }
-    return i;
+        const auto lineVertexBegin = vertex;
+        vertex = placeLine(lineBegin, end, baseline, offset, vertex);
+
+        if (lines)
+        {
+            lines->push_back(LineMetrics{ lineBegin, end, static_cast<size_t>(lineVertexBegin - begin)
+                , static_cast<size_t>(vertex - begin), baseline, width, offset.x, wordEnd });
+        }
+    };
+
+    // line breaks are found from column counts, then the line's glyphs are placed
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        if (lineBreaker.feedColumn<WordWrap>(i, column))
+        {
+            assert(i > 0);
+            finishLine(i);
+
+            column = 0;
+            baseline -= fontFace.lineHeight();
+            lineBegin = i;
+            wordEnd = lineBreaker.wordEnd(i);
+        }
+        column += lineBreaker.columns(i);
+    }
+
+    if (!glyphs.empty())
+        finishLine(glyphs.size());
+
+    return extent;
 }
 
-inline void Typesetter::typeset_glyph(
-    const FontFace & fontFace
-,   const glm::vec2 & pen
-,   const Glyph & glyph
-,   const GlyphVertexCloud::Vertices::iterator & vertex)
+void Typesetter::typeset(
+    const GlyphSequence & sequence
+,   const std::vector<glm::mat4> & glyphTransforms
+,   const GlyphVertexCloud::Vertices::iterator & begin)
 {
-    const auto & padding = fontFace.glyphTexturePadding();
-    vertex->origin    = glm::vec3(pen, 0.f);
-    vertex->origin.x += glyph.bearing().x - padding[3];
-    vertex->origin.y += glyph.bearing().y - glyph.extent().y + padding[0];
-
-    vertex->vtan   = glm::vec3(glyph.extent().x, 0.f, 0.f);
-    vertex->vbitan = glm::vec3(0.f, glyph.extent().y, 0.f);
+    assert(glyphTransforms.size() == sequence.depictableSize());
+    if (glyphTransforms.empty())
+        return;
 
-    const auto ll = glyph.subTextureOrigin();
-    const auto ur = glyph.subTextureOrigin() + glyph.subTextureExtent();
-    vertex->uvRect = glm::vec4(ll, ur);
+    typeset(sequence, glyphTransforms, &*begin);
 }
 
-inline void Typesetter::typeset_extent(
-    const FontFace & fontFace
-,   std::u32string::const_iterator index
-,   const std::u32string::const_iterator & begin
-,   glm::vec2 & pen
-,   glm::vec2 & extent)
+void Typesetter::typeset(
+    const GlyphSequence & sequence
+,   const std::vector<glm::mat4> & glyphTransforms
+,   GlyphVertexCloud::Vertex * begin)
 {
-    // on line feed, revert advance of preceding, not depictable glyphs
-    while (index > begin)
+    assert(glyphTransforms.size() == sequence.depictableSize());
+
+    const auto & fontFace = *sequence.fontFace();
+
+    const auto & glyphs = sequence.glyphRun();
+    const LineBreaker lineBreaker(sequence, false, 0.f);
+
+    auto pen = glm::vec2(0.f);
+    auto column = std::ptrdiff_t(0);
+    auto vertex = begin;
+
+    for (size_t i = 0; i < glyphs.size(); ++i)
     {
-        auto precedingGlyph = fontFace.glyph(*index);
-        if (precedingGlyph.depictable())
-            break;
+        const auto & glyph = *glyphs[i].glyph;
+
+        pen.x += glyphs[i].kerning;
+
+        if (glyph.depictable())
+            typeset_glyph(fontFace, pen, glyph, vertex++);
 
-        pen.x -= precedingGlyph.advance();
-        --index;
+        lineBreaker.advance(i, pen.x, column);
     }
-    extent.x = glm::max(pen.x, extent.x);
-    extent.y += fontFace.lineHeight();
+
+    const auto offset = glm::vec2(-0.f, anchor_offset(sequence));
+
+    auto transform = glyphTransforms.cbegin();
+    for (auto v = begin; v != vertex; ++v)
+        vertex_transform(*transform++, offset, sequence.fontColor(), sequence.superSampling(), v, v + 1, v);
 }
 
-inline void Typesetter::typeset_align(
-    const glm::vec2 & pen
-,   const Alignment alignment
-,   const GlyphVertexCloud::Vertices::iterator & begin
-,   const GlyphVertexCloud::Vertices::iterator & end)
+void Typesetter::typeset(
+    const GlyphSequence & sequence
+,   const ArcLengthTable & baseline
+,   const float start
+,   const GlyphVertexCloud::Vertices::iterator & begin)
 {
-    if (alignment == Alignment::LeftAligned)
+    if (sequence.depictableSize() == 0)
         return;
 
-    auto penOffset = -pen.x;
+    typeset(sequence, baseline, start, &*begin);
+}
+
+void Typesetter::typeset(
+    const GlyphSequence & sequence
+,   const ArcLengthTable & baseline
+,   const float start
+,   GlyphVertexCloud::Vertex * begin)
+{
+    assert(baseline.points().size() > 1);
+
+    const auto & fontFace = *sequence.fontFace();
+    const auto scale = sequence.fontSize() / fontFace.size();
+
+    // single line pen walk as for per glyph transforms; the line's width excludes trailing
+    // glyphs that are not depictable
+    const auto & glyphs = sequence.glyphRun();
+    const LineBreaker lineBreaker(sequence, false, 0.f);
+
+    auto pen = 0.f;
+    auto column = std::ptrdiff_t(0);
+    auto width = 0.f;
+    auto vertex = begin;
+
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        const auto & glyph = *glyphs[i].glyph;
+
+        pen += glyphs[i].kerning;
+
+        const auto depictable = glyph.depictable();
+        if (depictable)
+            typeset_glyph(fontFace, glm::vec2(pen, 0.f), glyph, vertex++);
+
+        lineBreaker.advance(i, pen, column);
+        if (depictable)
+            width = pen;
+    }
+
+    const auto offset = glm::vec2(0.f, anchor_offset(sequence));
+    const auto lineBegin = start + align_offset(width, sequence.alignment()) * scale;
+
+    // the frame at each glyph's center on the baseline maps its font face space to the
+    // baseline's space, the sequence's additional transform is applied thereafter
+    auto segment = size_t(0);
+    auto frame = glm::mat4();
+    frame[2] = glm::vec4(0.f, 0.f, scale, 0.f);
+
+    for (auto v = begin; v != vertex; ++v)
+    {
+        const auto center = v->origin.x + v->vtan.x * 0.5f;
+        const auto arcLength = lineBegin + center * scale;
 
-    if (alignment == Alignment::Centered)
-        penOffset *= 0.5f;
+        segment = baseline.segment(arcLength, segment);
+        const auto position = baseline.position(arcLength, segment);
+        const auto tangent = baseline.segmentTangent(segment);
 
-    // origin is expected to be in 'font face space' (not transformed)
-    for (auto v = begin; v != end; ++v)
-        v->origin.x += penOffset;
+        frame[0] = glm::vec4(tangent * scale, 0.f, 0.f);
+        frame[1] = glm::vec4(-tangent.y * scale, tangent.x * scale, 0.f, 0.f);
+        frame[3] = glm::vec4(position - tangent * (center * scale), 0.f, 1.f);
+
+        vertex_transform(sequence.additionalTransform() * frame, offset, sequence.fontColor()
+            , sequence.superSampling(), v, v + 1, v);
+    }
 }
 
-inline void Typesetter::anchor_transform(
+glm::vec2 Typesetter::measureLines(
     const GlyphSequence & sequence
-,   const GlyphVertexCloud::Vertices::iterator & begin
-,   const GlyphVertexCloud::Vertices::iterator & end)
+,   std::vector<LineMetrics> & lines)
+{
+    lines.clear();
+
+    const auto & fontFace = *sequence.fontFace();
+    const auto & glyphs = sequence.glyphRun();
+
+    // line breaking as done by typeset
+    LineBreaker lineBreaker(sequence, sequence.wordWrap(), sequence.lineWidth());
+
+    auto pen = glm::vec2(0.f);
+    auto column = std::ptrdiff_t(0);
+    auto extent = glm::vec2(0.f);
+    auto vertex = size_t(0);
+    auto line = LineMetrics{ 0, 0, 0, 0, 0.f, 0.f, 0.f, 0 };
+
+    const auto endLine = [&](const size_t end)
+    {
+        lineBreaker.revert(end - 1, pen.x, column);
+        typeset_extent(fontFace, pen, extent);
+
+        line.end = end;
+        line.vertexEnd = vertex;
+        line.width = pen.x;
+        line.offset = align_offset(pen.x, sequence.alignment());
+        lines.push_back(line);
+    };
+
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        if (lineBreaker.feedLine(i, pen.x))
+        {
+            assert(i > 0);
+            endLine(i);
+
+            pen.x = 0.f;
+            pen.y -= fontFace.lineHeight();
+            column = 0;
+            line = LineMetrics{ i, i, vertex, vertex, pen.y, 0.f, 0.f, lineBreaker.wordEnd(i) };
+        }
+        else if (i > 0)
+            pen.x += glyphs[i].kerning;
+
+        if (glyphs[i].glyph->depictable())
+            ++vertex;
+
+        lineBreaker.advance(i, pen.x, column);
+    }
+
+    if (!glyphs.empty())
+        endLine(glyphs.size());
+
+    return extent;
+}
+
+void Typesetter::typeset(
+    const GlyphSequence & sequence
+,   const std::vector<LineMetrics> & lines
+,   const size_t firstLine
+,   const size_t lastLine
+,   GlyphVertexCloud::Vertex * begin)
+{
+    assert(firstLine <= lastLine && lastLine <= lines.size());
+
+    const auto & fontFace = *sequence.fontFace();
+    const auto & glyphs = sequence.glyphRun();
+    const auto offsetY = anchor_offset(sequence);
+
+    const LineBreaker lineBreaker(sequence, false, 0.f);
+    auto vertex = begin;
+
+    // line breaks, baselines, and widths are known, so each line is typeset independently
+    for (auto l = firstLine; l < lastLine; ++l)
+    {
+        const auto & line = lines[l];
+        assert(line.end <= glyphs.size());
+
+        auto pen = glm::vec2(0.f, line.baseline);
+        auto column = std::ptrdiff_t(0);
+        const auto lineBegin = vertex;
+
+        for (auto i = line.begin; i < line.end; ++i)
+        {
+            const auto & glyph = *glyphs[i].glyph;
+
+            if (i > line.begin) // no kerning at line feeds
+                pen.x += glyphs[i].kerning;
+
+            if (glyph.depictable())
+                typeset_glyph(fontFace, pen, glyph, vertex++);
+
+            lineBreaker.advance(i, pen.x, column);
+        }
+
+        const auto offset = glm::vec2(align_offset(line.width, sequence.alignment()), offsetY);
+        vertex_transform(sequence.transform(), offset, sequence.fontColor(), sequence.superSampling()
+            , lineBegin, vertex, lineBegin);
+    }
+}
+
+glm::vec2 Typesetter::retypeset(
+    const GlyphSequence & sequence
+,   const GlyphSequence::Edit & edit
+,   std::vector<LineMetrics> & lines
+,   GlyphVertexCloud::Vertices & vertices)
+{
+    const auto & fontFace = *sequence.fontFace();
+    const auto & string = sequence.string();
+    const auto & glyphs = sequence.glyphRun();
+
+    // line breaks depend on the width of the word that follows, so the first affected line
+    // is the one with the last delimiter preceding the edit
+    auto delimiter = std::min(edit.begin, string.size());
+    while (delimiter > 0 && !isDelimiter(string[delimiter - 1]))
+        --delimiter;
+
+    const auto first = static_cast<size_t>(std::partition_point(lines.cbegin(), lines.cend(),
+        [&](const LineMetrics & line) { return line.end < delimiter; }) - lines.cbegin());
+    const auto start = first < lines.size() ? lines[first] : LineMetrics{ 0, 0, 0, 0, 0.f, 0.f, 0.f, 0 };
+
+    // typeset from the first affected line until a line begins at an unedited character,
+    // with line index and line breaking state as before the edit
+    LineBreaker lineBreaker(sequence, sequence.wordWrap(), sequence.lineWidth(), start.wordEnd);
+    const auto offsetY = anchor_offset(sequence);
+
+    std::vector<LineMetrics> retypesetLines;
+    GlyphVertexCloud::Vertices retypesetVertices;
+
+    auto pen = glm::vec2(0.f, start.baseline);
+    auto column = std::ptrdiff_t(0);
+    auto line = start;
+    auto resync = lines.size();
+
+    const auto endLine = [&](const size_t end)
+    {
+        lineBreaker.revert(end - 1, pen.x, column);
+
+        line.end = end;
+        line.vertexEnd = start.vertexBegin + retypesetVertices.size();
+        line.width = pen.x;
+        line.offset = align_offset(pen.x, sequence.alignment());
+        retypesetLines.push_back(line);
+
+        const auto lineBegin = retypesetVertices.data() + (line.vertexBegin - start.vertexBegin);
+        const auto offset = glm::vec2(line.offset, offsetY);
+        vertex_transform(sequence.transform(), offset, sequence.fontColor(), sequence.superSampling()
+            , lineBegin, retypesetVertices.data() + retypesetVertices.size(), lineBegin);
+    };
+
+    for (auto i = start.begin; i < glyphs.size(); ++i)
+    {
+        const auto & glyph = *glyphs[i].glyph;
+
+        // the first line is known to begin at start.begin; yet, typeset updates the line
+        // breaking state at the very first glyph (which is never fed), so this does too
+        if ((i > start.begin || i == 0) && lineBreaker.feedLine(i, pen.x))
+        {
+            assert(i > 0);
+            endLine(i);
+
+            pen.x = 0.f;
+            pen.y -= fontFace.lineHeight();
+            column = 0;
+            line = LineMetrics{ i, i, line.vertexEnd, line.vertexEnd, pen.y, 0.f, 0.f, lineBreaker.wordEnd(i) };
+
+            const auto k = first + retypesetLines.size();
+            if (i >= edit.newEnd && k < lines.size() && lines[k].begin + edit.newEnd == i + edit.oldEnd
+                && lines[k].wordEnd - lines[k].begin == line.wordEnd - i && lines[k].baseline == pen.y)
+            {
+                resync = k;
+                break;
+            }
+        }
+        else if (i > start.begin)
+            pen.x += glyphs[i].kerning;
+
+        if (glyph.depictable())
+        {
+            retypesetVertices.emplace_back();
+            typeset_glyph(fontFace, pen, glyph, &retypesetVertices.back());
+        }
+
+        lineBreaker.advance(i, pen.x, column);
+    }
+
+    if (resync == lines.size() && start.begin < glyphs.size())
+        endLine(glyphs.size());
+
+    // patch the vertices and lines that were typeset again, and shift the ones that follow
+    const auto vertexEnd = resync < lines.size() ? lines[resync].vertexBegin : vertices.size();
+    const auto vertexShift = start.vertexBegin + retypesetVertices.size() - vertexEnd; // modular
+
+    for (auto k = resync; k < lines.size(); ++k)
+    {
+        lines[k].begin = lines[k].begin + edit.newEnd - edit.oldEnd;
+        lines[k].end = lines[k].end + edit.newEnd - edit.oldEnd;
+        lines[k].wordEnd = lines[k].wordEnd + edit.newEnd - edit.oldEnd;
+        lines[k].vertexBegin += vertexShift;
+        lines[k].vertexEnd += vertexShift;
+    }
+
+    lines.erase(lines.begin() + first, lines.begin() + resync);
+    lines.insert(lines.begin() + first, retypesetLines.cbegin(), retypesetLines.cend());
+
+    const auto patched = std::min(retypesetVertices.size(), vertexEnd - start.vertexBegin);
+    std::copy(retypesetVertices.cbegin(), retypesetVertices.cbegin() + patched, vertices.begin() + start.vertexBegin);
+    if (patched < retypesetVertices.size())
+        vertices.insert(vertices.begin() + vertexEnd, retypesetVertices.cbegin() + patched, retypesetVertices.cend());
+    else
+        vertices.erase(vertices.begin() + start.vertexBegin + patched, vertices.begin() + vertexEnd);
+
+    auto extent = glm::vec2(0.f);
+    for (const auto & l : lines)
+        typeset_extent(fontFace, glm::vec2(l.width, 0.f), extent);
+
+    return extent_transform(sequence, extent);
+}
+
+size_t Typesetter::fittingPrefix(
+    const GlyphSequence & sequence
+,   const float width)
+{
+    const auto & advances = sequence.prefixAdvances();
+    const auto faceWidth = width * sequence.fontFace()->size() / sequence.fontSize();
+
+    return static_cast<size_t>(std::upper_bound(advances.cbegin() + 1, advances.cend(), faceWidth) - advances.cbegin()) - 1;
+}
+
+float Typesetter::width(
+    const GlyphSequence & sequence
+,   const size_t begin
+,   const size_t end)
+{
+    assert(begin <= end && end <= sequence.size());
+    if (begin == end)
+        return 0.f;
+
+    // the kerning w.r.t. the preceding glyph does not apply at the beginning of a line
+    const auto & advances = sequence.prefixAdvances();
+    const auto kerning = begin > 0 ? sequence.glyphRun()[begin].kerning : 0.f;
+
+    return (advances[end] - advances[begin] - kerning) * (sequence.fontSize() / sequence.fontFace()->size());
+}
+
+size_t Typesetter::indexAt(
+    const GlyphSequence & sequence
+,   const float x)
+{
+    const auto & advances = sequence.prefixAdvances();
+    const auto faceX = x * sequence.fontFace()->size() / sequence.fontSize();
+
+    const auto next = std::lower_bound(advances.cbegin(), advances.cend(), faceX);
+    if (next == advances.cbegin())
+        return 0;
+    if (next == advances.cend())
+        return sequence.size();
+
+    const auto index = static_cast<size_t>(next - advances.cbegin());
+    return *next - faceX < faceX - *(next - 1) ? index : index - 1;
+}
+
+glm::vec2 Typesetter::typesetTruncated(
+    const GlyphSequence & sequence
+,   const float width
+,   GlyphVertexCloud::Vertex * begin
+,   size_t & vertexCount
+,   const std::u32string & ellipsis)
 {
-    auto offset = 0.f;
+    const auto & fontFace = *sequence.fontFace();
+    const auto & string = sequence.string();
+    const auto & glyphs = sequence.glyphRun();
+    const auto & advances = sequence.prefixAdvances();
+
+    const auto faceWidth = glm::max(width * fontFace.size() / sequence.fontSize(), 0.f);
+    const auto depictable = [&](const size_t index) { return glyphs[index].glyph->depictable(); };
+
+    // with fixed pitch, the prefix sums are column pens; the ellipsis continues in columns if
+    // its glyphs are of the same pitch
+    const auto pitch = sequence.fixedPitch();
+    auto ellipsisPitch = pitch;
+    for (const auto c : ellipsis)
+        ellipsisPitch = fontFace.glyph(c).advance() == pitch ? ellipsisPitch : 0.f;
+    const auto column = [&](const size_t length) { return static_cast<std::ptrdiff_t>(std::lround(advances[length] / pitch)); };
+
+    // the width of the whole line, reverting the advance of trailing glyphs as typeset does
+    auto end = glyphs.size();
+    auto lineWidth = advances[end];
+    auto last = end;
+    for (; last > 1 && !depictable(last - 1); --last)
+        lineWidth -= glyphs[last - 1].glyph->advance();
+    if (pitch > 0.f)
+        lineWidth = advances[last];
+
+    // the pen after the ellipsis appended to the first glyphs [0, length), advanced as typeset does
+    const auto ellipsisEnd = [&](const size_t length)
+    {
+        if (ellipsisPitch > 0.f)
+            return columnPen(column(length) + static_cast<std::ptrdiff_t>(ellipsis.size()), pitch);
+
+        auto pen = advances[length];
+        for (size_t i = 0; i < ellipsis.size(); ++i)
+        {
+            if (i > 0 || length > 0)
+                pen += fontFace.kerning(i > 0 ? ellipsis[i - 1] : string[length - 1], ellipsis[i]);
+            pen += fontFace.glyph(ellipsis[i]).advance();
+        }
+        return pen;
+    };
+
+    const auto truncated = lineWidth > faceWidth;
+    if (truncated)
+    {
+        // the longest prefix that fits with the ellipsis, ending with a depictable glyph
+        end = static_cast<size_t>(std::upper_bound(advances.cbegin() + 1, advances.cend()
+            , faceWidth - ellipsisEnd(0)) - advances.cbegin()) - 1;
+
+        // the prefix sums and the ellipsis are rounded apart, which may fit a little more
+        while (end < glyphs.size() && ellipsisEnd(end + 1) <= faceWidth)
+            ++end;
+        while (end > 0 && (!depictable(end - 1) || ellipsisEnd(end) > faceWidth))
+            --end;
+
+        lineWidth = ellipsisEnd(end);
+    }
+
+    auto pen = glm::vec2(0.f);
+    auto vertex = begin;
+
+    // the prefix sums provide the pen of each glyph
+    for (size_t i = 0; i < end; ++i)
+    {
+        if (!depictable(i))
+            continue;
+
+        pen.x = i > 0 ? advances[i] + glyphs[i].kerning : 0.f;
+        typeset_glyph(fontFace, pen, *glyphs[i].glyph, vertex++);
+    }
+
+    if (truncated)
+    {
+        pen.x = advances[end];
+        for (size_t i = 0; i < ellipsis.size(); ++i)
+        {
+            if (i > 0 || end > 0)
+                pen.x += fontFace.kerning(i > 0 ? ellipsis[i - 1] : string[end - 1], ellipsis[i]);
+
+            const auto & glyph = fontFace.glyph(ellipsis[i]);
+            if (ellipsisPitch > 0.f)
+                pen.x = columnPen(column(end) + static_cast<std::ptrdiff_t>(i), pitch);
+            if (glyph.depictable())
+                typeset_glyph(fontFace, pen, glyph, vertex++);
+
+            pen.x += glyph.advance();
+        }
+    }
+
+    vertexCount = static_cast<size_t>(vertex - begin);
+
+    const auto offset = glm::vec2(align_offset(lineWidth, sequence.alignment()), anchor_offset(sequence));
+    vertex_transform(sequence.transform(), offset, sequence.fontColor(), sequence.superSampling(), begin, vertex, begin);
+
+    auto extent = glm::vec2(0.f);
+    if (!glyphs.empty())
+        typeset_extent(fontFace, glm::vec2(lineWidth, 0.f), extent);
+    return extent_transform(sequence, extent);
+}
 
+float Typesetter::anchorOffset(const GlyphSequence & sequence)
+{
     switch (sequence.lineAnchor())
     {
     case LineAnchor::Ascent:
-        offset = sequence.fontFace()->ascent();
-        break;
+        return sequence.fontFace()->ascent();
     case LineAnchor::Center:
-        offset = sequence.fontFace()->size() * 0.5f + sequence.fontFace()->descent();
-        break;
+        return sequence.fontFace()->size() * 0.5f + sequence.fontFace()->descent();
     case LineAnchor::Descent:
-        offset = sequence.fontFace()->descent();
-        break;
+        return sequence.fontFace()->descent();
     case LineAnchor::Top:
-        offset = sequence.fontFace()->base();
-        break;
+        return sequence.fontFace()->base();
     case LineAnchor::Bottom:
-        offset = sequence.fontFace()->base() - sequence.fontFace()->lineHeight();
-        break;
+        return sequence.fontFace()->base() - sequence.fontFace()->lineHeight();
     case LineAnchor::Baseline:
     default:
+        return 0.f;
+    }
+}
+
+glm::vec2 Typesetter::typeset_measure(
+    const GlyphSequence & sequence
+,   const float lineWidth)
+{
+    auto extent = glm::vec2(0.f);
+    if (s_extentCache && s_extentCache->find(sequence.string(), sequence.fontFace(), lineWidth, extent))
+        return extent;
+
+    extent = typeset_measure(*sequence.fontFace(), sequence.string(), sequence.glyphRun(), sequence.fixedPitch(), lineWidth, nullptr);
+
+    if (s_extentCache)
+        s_extentCache->insert(sequence.string(), sequence.fontFace(), lineWidth, extent);
+    return extent;
+}
+
+glm::vec2 Typesetter::typeset_measure(
+    const FontFace & fontFace
+,   const std::u32string & string
+,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+,   const float pitch
+,   const float lineWidth
+,   std::vector<float> * lineWidths)
+{
+    if (lineWidth >= 0.f)
+        return pitch > 0.f ? typeset_measure_kernel<true, true>(fontFace, string, glyphs, pitch, lineWidth, lineWidths)
+            : typeset_measure_kernel<true, false>(fontFace, string, glyphs, pitch, lineWidth, lineWidths);
+
+    return pitch > 0.f ? typeset_measure_kernel<false, true>(fontFace, string, glyphs, pitch, lineWidth, lineWidths)
+        : typeset_measure_kernel<false, false>(fontFace, string, glyphs, pitch, lineWidth, lineWidths);
+}
+
+template <bool FixedPitch>
+void Typesetter::typeset_measure_widths(
+    const FontFace & fontFace
+,   const std::u32string & string
+,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+,   const float pitch
+,   const std::vector<float> & lineWidths
+,   std::vector<glm::vec2> & extents)
+{
+    // line breaking as done by typeset_measure_kernel, glyph by glyph for all widths
+    std::vector<LineBreaker> lineBreakers;
+    lineBreakers.reserve(lineWidths.size());
+    for (const auto width : lineWidths)
+        lineBreakers.emplace_back(string, glyphs, pitch, width >= 0.f, width);
+
+    // with fixed pitch, pens are kept as columns
+    std::vector<glm::vec2> pens(lineWidths.size(), glm::vec2(0.f));
+    std::vector<std::ptrdiff_t> columns(FixedPitch ? lineWidths.size() : 0, 0);
+    extents.assign(lineWidths.size(), glm::vec2(0.f));
+
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        const auto advance = FixedPitch ? 0.f : lineBreakers.front().advance(i);
+        for (size_t w = 0; w < lineBreakers.size(); ++w)
+        {
+            auto & lineBreaker = lineBreakers[w];
+            auto & pen = pens[w];
+
+            if (FixedPitch)
+            {
+                auto & column = columns[w];
+                const auto feed = lineWidths[w] >= 0.f ? lineBreaker.feedColumn<true>(i, column)
+                    : lineBreaker.feedColumn<false>(i, column);
+                if (feed)
+                {
+                    assert(i > 0);
+                    lineBreaker.revertColumns(i - 1, column);
+                    typeset_extent(fontFace, glm::vec2(columnPen(column, pitch), 0.f), extents[w]);
+                    column = 0;
+                }
+                column += lineBreaker.columns(i);
+                continue;
+            }
+
+            const auto feed = lineWidths[w] >= 0.f ? lineBreaker.feedLine<true, false>(i, pen.x)
+                : lineBreaker.feedLine<false, false>(i, pen.x);
+            if (feed)
+            {
+                assert(i > 0);
+                lineBreaker.revert(i - 1, pen.x);
+                typeset_extent(fontFace, pen, extents[w]);
+                pen.x = 0.f;
+            }
+            else if (i > 0)
+                pen.x += glyphs[i].kerning;
+
+            pen.x += advance;
+        }
+    }
+
+    if (glyphs.empty())
         return;
+
+    for (size_t w = 0; w < lineBreakers.size(); ++w)
+    {
+        if (FixedPitch)
+        {
+            lineBreakers[w].revertColumns(glyphs.size() - 1, columns[w]);
+            pens[w].x = columnPen(columns[w], pitch);
+        }
+        else
+            lineBreakers[w].revert(glyphs.size() - 1, pens[w].x);
+        typeset_extent(fontFace, pens[w], extents[w]);
+    }
+}
+
+template <bool WordWrap, bool FixedPitch>
+glm::vec2 Typesetter::typeset_measure_kernel(
+    const FontFace & fontFace
+,   const std::u32string & string
+,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+,   const float pitch
+,   const float lineWidth
+,   std::vector<float> * lineWidths)
+{
+    // line breaking as done by typeset, with fixed pitch by columns
+    LineBreaker lineBreaker(string, glyphs, pitch, WordWrap, lineWidth);
+    auto pen = glm::vec2(0.f);
+    auto column = std::ptrdiff_t(0);
+    auto extent = glm::vec2(0.f);
+
+    if (lineWidths)
+        lineWidths->clear();
+
+    const auto endLine = [&](const size_t last)
+    {
+        if (FixedPitch)
+        {
+            lineBreaker.revertColumns(last, column);
+            pen.x = columnPen(column, pitch);
+        }
+        else
+            lineBreaker.revert(last, pen.x);
+
+        typeset_extent(fontFace, pen, extent);
+        if (lineWidths)
+            lineWidths->push_back(pen.x);
+    };
+
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        if (FixedPitch ? lineBreaker.feedColumn<WordWrap>(i, column) : lineBreaker.feedLine<WordWrap, false>(i, pen.x))
+        {
+            assert(i > 0);
+            endLine(i - 1);
+            pen.x = 0.f;
+            column = 0;
+        }
+        else if (!FixedPitch && i > 0)
+            pen.x += glyphs[i].kerning;
+
+        if (FixedPitch)
+            column += lineBreaker.columns(i);
+        else
+            pen.x += lineBreaker.advance(i);
+    }
+
+    if (!glyphs.empty())
+        endLine(glyphs.size() - 1);
+
+    return extent;
+}
+
+glm::vec2 Typesetter::typeset_measure_bracket(
+    const FontFace & fontFace
+,   const std::u32string & string
+,   const std::vector<GlyphSequence::ResolvedGlyph> & glyphs
+,   const float pitch
+,   const float lineWidth
+,   glm::vec2 & lineWidths)
+{
+    // word wrapped as done by typeset_measure_kernel
+    LineBreaker lineBreaker(string, glyphs, pitch, true, lineWidth);
+    if (pitch > 0.f)
+    {
+        lineWidths = lineBreaker.columnBracket();
+        return typeset_measure_kernel<true, true>(fontFace, string, glyphs, pitch, lineWidth, nullptr);
+    }
+
+    auto pen = glm::vec2(0.f);
+    auto extent = glm::vec2(0.f);
+
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        if (lineBreaker.feedLine<true, false, true>(i, pen.x))
+        {
+            assert(i > 0);
+            lineBreaker.revert(i - 1, pen.x);
+            typeset_extent(fontFace, pen, extent);
+            pen.x = 0.f;
+        }
+        else if (i > 0)
+            pen.x += glyphs[i].kerning;
+
+        pen.x += lineBreaker.advance(i);
+    }
+
+    if (!glyphs.empty())
+    {
+        lineBreaker.revert(glyphs.size() - 1, pen.x);
+        typeset_extent(fontFace, pen, extent);
+    }
+
+    lineWidths = lineBreaker.bracket();
+    return extent;
+}
+
+inline void Typesetter::typeset_glyph(
+    const FontFace & fontFace
+,   const glm::vec2 & pen
+,   const Glyph & glyph
+,   GlyphVertexCloud::Vertex * vertex)
+{
+    const auto & padding = fontFace.glyphTexturePadding();
+    vertex->origin    = glm::vec3(pen, 0.f);
+    vertex->origin.x += glyph.bearing().x - padding[3];
+    vertex->origin.y += glyph.bearing().y - glyph.extent().y + padding[0];
+
+    vertex->vtan   = glm::vec3(glyph.extent().x, 0.f, 0.f);
+    vertex->vbitan = glm::vec3(0.f, glyph.extent().y, 0.f);
+
+    const auto ll = glyph.subTextureOrigin();
+    const auto ur = glyph.subTextureOrigin() + glyph.subTextureExtent();
+    vertex->uvRect = glm::vec4(ll, ur);
+}
+
+inline void Typesetter::typeset_extent(
+    const FontFace & fontFace
+,   const glm::vec2 & pen
+,   glm::vec2 & extent)
+{
+    extent.x = glm::max(pen.x, extent.x);
+    extent.y += fontFace.lineHeight();
+}
+
+inline float Typesetter::align_offset(
+    const float penX
+,   const Alignment alignment)
+{
+    // -0 leaves any x unchanged when added (as does not adding it)
+    switch (alignment)
+    {
+    case Alignment::Centered:
+        return -penX * 0.5f;
+    case Alignment::RightAligned:
+        return -penX;
+    case Alignment::LeftAligned:
+    default:
+        return -0.f;
     }
+}
+
+inline float Typesetter::anchor_offset(const GlyphSequence & sequence)
+{
+    if (sequence.lineAnchor() == LineAnchor::Baseline)
+        return -0.f;
 
-    for (auto v = begin; v != end; ++v)
-        v->origin.y -= offset;
+    return -anchorOffset(sequence);
 }
 
 inline void Typesetter::vertex_transform(
     const glm::mat4 & transform
+,   const glm::vec2 & offset
 ,   const glm::vec4 & fontColor
 ,   const SuperSampling & superSampling
-,   const GlyphVertexCloud::Vertices::iterator & begin
-,   const GlyphVertexCloud::Vertices::iterator & end)
+,   const GlyphVertexCloud::Vertex * begin
+,   const GlyphVertexCloud::Vertex * end
+,   GlyphVertexCloud::Vertex * destination)
 {
-    for (auto v = begin; v != end; ++v)
+    // each vertex is read completely before it is written, so destination may equal begin
+    auto d = destination;
+
+#ifdef OPENLL_TYPESETTER_SSE
+    const __m128 columns[4] = { _mm_loadu_ps(&transform[0][0]), _mm_loadu_ps(&transform[1][0])
+        , _mm_loadu_ps(&transform[2][0]), _mm_loadu_ps(&transform[3][0]) };
+
+    for (auto v = begin; v != end; ++v, ++d)
+    {
+        d->uvRect = v->uvRect;
+        transformQuad(columns, v->origin.x + offset.x, v->origin.y + offset.y, v->origin.z, v->vtan, v->vbitan, d);
+        d->fontColor = fontColor;
+        d->superSampling = static_cast<GLuint>(superSampling);
+    }
+#else
+    for (auto v = begin; v != end; ++v, ++d)
     {
-        auto ll = transform * glm::vec4(v->origin, 1.f);
-        auto lr = transform * glm::vec4(v->origin + v->vtan, 1.f);
-        auto ul = transform * glm::vec4(v->origin + v->vbitan, 1.f);
+        const auto origin = glm::vec3(v->origin.x + offset.x, v->origin.y + offset.y, v->origin.z);
 
+        const auto ll = transform * glm::vec4(origin, 1.f);
+        const auto lr = transform * glm::vec4(origin + v->vtan, 1.f);
+        const auto ul = transform * glm::vec4(origin + v->vbitan, 1.f);
 
-        v->origin = glm::vec3(ll);
-        v->vtan   = glm::vec3(lr - ll);
-        v->vbitan = glm::vec3(ul - ll);
-        v->fontColor = fontColor;
-        v->superSampling = static_cast<GLuint>(superSampling);
+        d->uvRect = v->uvRect;
+        d->origin = glm::vec3(ll);
+        d->vtan   = glm::vec3(lr - ll);
+        d->vbitan = glm::vec3(ul - ll);
+        d->fontColor = fontColor;
+        d->superSampling = static_cast<GLuint>(superSampling);
     }
+#endif
 }
 
 inline glm::vec2 Typesetter::extent_transform(
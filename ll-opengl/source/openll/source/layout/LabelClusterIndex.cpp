@@ -0,0 +1,242 @@
+#include <openll/layout/LabelClusterIndex.h>
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+#include <string>
+#include <algorithm>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <openll/layout/layoutbase.h>
+
+
+namespace
+{
+
+// leaf size of the kd-tree, ranges of this size are scanned linearly
+const std::size_t nodeSize = 64;
+
+struct Entry
+{
+    glm::vec2 location;
+    std::uint32_t id;
+};
+
+// orders entries[left, right] as implicit kd-tree (median split, alternating axes)
+void sortKD(std::vector<Entry> & entries, std::size_t left, std::size_t right, int axis)
+{
+    if (right - left <= nodeSize)
+        return;
+
+    const auto median = (left + right) / 2;
+    std::nth_element(entries.begin() + left, entries.begin() + median, entries.begin() + right + 1,
+        [axis](const Entry & a, const Entry & b) { return a.location[axis] < b.location[axis]; });
+
+    sortKD(entries, left, median - 1, 1 - axis);
+    sortKD(entries, median + 1, right, 1 - axis);
+}
+
+// visits all entries within the axis-aligned rectangle [lowerLeft, upperRight]
+template <typename Callback>
+void rangeKD(const std::vector<std::uint32_t> & ids, const std::vector<glm::vec2> & locations,
+    const glm::vec2 & lowerLeft, const glm::vec2 & upperRight, Callback callback)
+{
+    if (ids.empty())
+        return;
+
+    // every split pushes at most two ranges, so the stack is bounded by twice the tree depth
+    struct Range { std::size_t left; std::size_t right; int axis; };
+    std::array<Range, 128> stack;
+    auto top = std::size_t(0);
+    stack[top++] = { 0, ids.size() - 1, 0 };
+
+    const auto inside = [&](const glm::vec2 & p) {
+        return p.x >= lowerLeft.x && p.x <= upperRight.x && p.y >= lowerLeft.y && p.y <= upperRight.y; };
+
+    while (top > 0)
+    {
+        const auto range = stack[--top];
+
+        if (range.right - range.left <= nodeSize)
+        {
+            for (auto i = range.left; i <= range.right; ++i)
+            {
+                if (inside(locations[i]))
+                    callback(ids[i], locations[i]);
+            }
+            continue;
+        }
+
+        const auto median = (range.left + range.right) / 2;
+        const auto & p = locations[median];
+        if (inside(p))
+            callback(ids[median], p);
+
+        if (lowerLeft[range.axis] <= p[range.axis])
+            stack[top++] = { range.left, median - 1, 1 - range.axis };
+        if (upperRight[range.axis] >= p[range.axis])
+            stack[top++] = { median + 1, range.right, 1 - range.axis };
+    }
+}
+
+}
+
+
+namespace gloperate_text
+{
+
+
+LabelClusterIndex::LabelClusterIndex(const float radius, const unsigned int minZoom, const unsigned int maxZoom)
+: m_radius(radius)
+, m_minZoom(minZoom)
+, m_maxZoom(glm::max(minZoom, maxZoom))
+{
+}
+
+LabelClusterIndex::~LabelClusterIndex()
+{
+}
+
+float LabelClusterIndex::radius() const
+{
+    return m_radius;
+}
+
+unsigned int LabelClusterIndex::minZoom() const
+{
+    return m_minZoom;
+}
+
+unsigned int LabelClusterIndex::maxZoom() const
+{
+    return m_maxZoom;
+}
+
+void LabelClusterIndex::build(const std::vector<Label> & labels)
+{
+    m_levels.assign(m_maxZoom - m_minZoom + 2, Level());
+
+    auto entries = std::vector<Entry>();
+    const auto index = [&entries](Level & level)
+    {
+        entries.resize(level.clusters.size());
+        for (std::size_t i = 0; i < entries.size(); ++i)
+            entries[i] = { level.clusters[i].location, static_cast<std::uint32_t>(i) };
+        if (!entries.empty())
+            sortKD(entries, 0, entries.size() - 1, 0);
+
+        level.ids.resize(entries.size());
+        level.locations.resize(entries.size());
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+            level.ids[i] = entries[i].id;
+            level.locations[i] = entries[i].location;
+        }
+    };
+
+    // the finest level holds one cluster per label, ordered by descending priority
+    auto order = std::vector<std::uint32_t>(labels.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+        return labels[a].priority > labels[b].priority; });
+
+    auto & leaves = m_levels.back();
+    leaves.clusters.reserve(labels.size());
+    for (const auto i : order)
+        leaves.clusters.push_back({ labels[i].pointLocation, 1u, labels[i].priority, i });
+    index(leaves);
+
+    auto visited = std::vector<bool>();
+
+    // greedily merge the clusters of the next finer level, highest priority first;
+    // as each cluster inherits the priority of its seed, every level stays sorted by priority
+    for (auto zoom = m_maxZoom; ; --zoom)
+    {
+        const auto & finer = m_levels[zoom - m_minZoom + 1];
+        auto & current = m_levels[zoom - m_minZoom];
+
+        const auto radius = std::ldexp(m_radius, -static_cast<int>(zoom));
+        const auto extent = glm::vec2(radius);
+
+        visited.assign(finer.clusters.size(), false);
+        current.clusters.reserve(finer.clusters.size() / 2);
+
+        for (std::uint32_t id = 0; id < finer.clusters.size(); ++id)
+        {
+            if (visited[id])
+                continue;
+            visited[id] = true;
+
+            auto cluster = finer.clusters[id];
+            auto weighted = cluster.location * static_cast<float>(cluster.count);
+
+            rangeKD(finer.ids, finer.locations, cluster.location - extent, cluster.location + extent,
+                [&](std::uint32_t neighbor, const glm::vec2 & location)
+            {
+                if (visited[neighbor] || glm::distance(location, cluster.location) > radius)
+                    return;
+                visited[neighbor] = true;
+
+                const auto count = finer.clusters[neighbor].count;
+                weighted += location * static_cast<float>(count);
+                cluster.count += count;
+            });
+
+            cluster.location = weighted / static_cast<float>(cluster.count);
+            current.clusters.push_back(cluster);
+        }
+        index(current);
+
+        if (zoom == m_minZoom)
+            break;
+    }
+}
+
+std::size_t LabelClusterIndex::size(const unsigned int zoom) const
+{
+    return m_levels.empty() ? 0 : level(zoom).clusters.size();
+}
+
+std::vector<Label> LabelClusterIndex::query(const std::vector<Label> & labels,
+    const glm::vec2 & lowerLeft, const glm::vec2 & upperRight, const unsigned int zoom,
+    const ClusterContent content) const
+{
+    std::vector<Label> result;
+    if (m_levels.empty())
+        return result;
+
+    const auto & clusters = level(zoom);
+    assert(labels.size() == m_levels.back().clusters.size());
+
+    rangeKD(clusters.ids, clusters.locations, lowerLeft, upperRight,
+        [&](std::uint32_t id, const glm::vec2 &)
+    {
+        const auto & cluster = clusters.clusters[id];
+        result.push_back(labels[cluster.representative]);
+
+        if (cluster.count == 1)
+            return;
+
+        auto & label = result.back();
+        label.pointLocation = cluster.location;
+        label.priority = cluster.priority;
+
+        if (content == ClusterContent::Count)
+        {
+            const auto count = std::to_string(cluster.count);
+            label.sequence.setString(std::u32string(count.begin(), count.end()));
+        }
+    });
+    return result;
+}
+
+const LabelClusterIndex::Level & LabelClusterIndex::level(const unsigned int zoom) const
+{
+    return m_levels[glm::clamp(zoom, m_minZoom, m_maxZoom + 1) - m_minZoom];
+}
+
+
+} // namespace gloperate_text
@@ -0,0 +1,356 @@
+#include <openll/layout/LabelPolygon.h>
+
+#include <array>
+#include <cmath>
+#include <queue>
+#include <limits>
+#include <algorithm>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <openll/layout/RelativeLabelPosition.h>
+
+namespace
+{
+
+// number of segments per leaf of the hierarchy
+const std::uint32_t leafSize = 8;
+
+// a balanced hierarchy over 2^32 segments is less deep than this
+using Stack = std::array<std::uint32_t, 64>;
+
+float squaredDistance(const glm::vec2 & point, const glm::vec2 & a, const glm::vec2 & b)
+{
+    const auto ab = b - a;
+    const auto t = glm::clamp(glm::dot(point - a, ab) / glm::dot(ab, ab), 0.f, 1.f);
+    const auto delta = a + ab * t - point;
+    return glm::dot(delta, delta);
+}
+
+float squaredBoxDistance(const glm::vec2 & point, const glm::vec2 & lowerLeft, const glm::vec2 & upperRight)
+{
+    const auto delta = glm::max(glm::max(lowerLeft - point, point - upperRight), glm::vec2(0.f));
+    return glm::dot(delta, delta);
+}
+
+// Liang-Barsky clipping of the segment against the box, touching counts as intersecting
+bool intersects(const glm::vec2 & a, const glm::vec2 & b, const glm::vec2 & lowerLeft, const glm::vec2 & upperRight)
+{
+    const auto direction = b - a;
+    auto t0 = 0.f;
+    auto t1 = 1.f;
+
+    for (auto axis = 0; axis < 2; ++axis)
+    {
+        if (direction[axis] == 0.f)
+        {
+            if (a[axis] < lowerLeft[axis] || a[axis] > upperRight[axis])
+                return false;
+            continue;
+        }
+
+        auto tLower = (lowerLeft[axis] - a[axis]) / direction[axis];
+        auto tUpper = (upperRight[axis] - a[axis]) / direction[axis];
+        if (tLower > tUpper)
+            std::swap(tLower, tUpper);
+
+        t0 = glm::max(t0, tLower);
+        t1 = glm::min(t1, tUpper);
+        if (t0 > t1)
+            return false;
+    }
+    return true;
+}
+
+struct Cell
+{
+    glm::vec2 center;
+    float half;      // half of the cell's edge length
+    float distance;  // signed distance of the center to the boundary
+    float potential; // upper bound of the distance within the cell
+
+    bool operator<(const Cell & other) const
+    {
+        return potential < other.potential;
+    }
+};
+
+}
+
+
+namespace gloperate_text
+{
+
+
+LabelPolygon::LabelPolygon(const std::vector<std::vector<glm::vec2>> & rings)
+{
+    for (const auto & ring : rings)
+    {
+        for (size_t i = 0; i < ring.size(); ++i)
+        {
+            const auto & a = ring[i];
+            const auto & b = ring[(i + 1) % ring.size()];
+            if (a != b)
+                m_segments.push_back({a, b});
+        }
+    }
+
+    if (m_segments.empty())
+        return;
+
+    m_nodes.reserve(2 * m_segments.size() / leafSize + 1);
+    m_nodes.resize(1);
+    build(0, 0, static_cast<std::uint32_t>(m_segments.size()));
+}
+
+LabelPolygon::~LabelPolygon()
+{
+}
+
+void LabelPolygon::build(const std::uint32_t node, const std::uint32_t begin, const std::uint32_t end)
+{
+    auto lowerLeft = glm::vec2(std::numeric_limits<float>::max());
+    auto upperRight = glm::vec2(std::numeric_limits<float>::lowest());
+    for (auto i = begin; i < end; ++i)
+    {
+        lowerLeft = glm::min(lowerLeft, glm::min(m_segments[i].a, m_segments[i].b));
+        upperRight = glm::max(upperRight, glm::max(m_segments[i].a, m_segments[i].b));
+    }
+    m_nodes[node].lowerLeft = lowerLeft;
+    m_nodes[node].upperRight = upperRight;
+
+    if (end - begin <= leafSize)
+    {
+        m_nodes[node].first = begin;
+        m_nodes[node].count = end - begin;
+        return;
+    }
+
+    // median split along the longer side
+    const auto extent = upperRight - lowerLeft;
+    const auto axis = extent.x >= extent.y ? 0 : 1;
+    const auto middle = begin + (end - begin) / 2;
+    std::nth_element(m_segments.begin() + begin, m_segments.begin() + middle, m_segments.begin() + end,
+        [axis](const Segment & s, const Segment & t) { return s.a[axis] + s.b[axis] < t.a[axis] + t.b[axis]; });
+
+    const auto first = static_cast<std::uint32_t>(m_nodes.size());
+    m_nodes.resize(m_nodes.size() + 2);
+    m_nodes[node].first = first;
+    m_nodes[node].count = 0;
+
+    build(first, begin, middle);
+    build(first + 1, middle, end);
+}
+
+bool LabelPolygon::contains(const glm::vec2 & point) const
+{
+    if (m_nodes.empty())
+        return false;
+
+    // even-odd rule, counting crossings of a ray in positive x direction
+    auto inside = false;
+
+    Stack stack;
+    auto top = std::size_t(0);
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const auto & node = m_nodes[stack[--top]];
+        if (point.y < node.lowerLeft.y || point.y > node.upperRight.y || point.x > node.upperRight.x)
+            continue;
+
+        if (node.count == 0)
+        {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+            continue;
+        }
+
+        for (auto i = node.first; i < node.first + node.count; ++i)
+        {
+            const auto & a = m_segments[i].a;
+            const auto & b = m_segments[i].b;
+            if ((a.y > point.y) != (b.y > point.y)
+                && point.x < (b.x - a.x) * (point.y - a.y) / (b.y - a.y) + a.x)
+                inside = !inside;
+        }
+    }
+    return inside;
+}
+
+bool LabelPolygon::contains(const LabelArea & area) const
+{
+    if (!contains(area.origin))
+        return false;
+
+    // with one corner inside, the area is inside if no boundary segment touches it
+    const auto lowerLeft = area.origin;
+    const auto upperRight = area.origin + area.extent;
+
+    Stack stack;
+    auto top = std::size_t(0);
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const auto & node = m_nodes[stack[--top]];
+        if (node.upperRight.x < lowerLeft.x || node.lowerLeft.x > upperRight.x
+            || node.upperRight.y < lowerLeft.y || node.lowerLeft.y > upperRight.y)
+            continue;
+
+        if (node.count == 0)
+        {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+            continue;
+        }
+
+        for (auto i = node.first; i < node.first + node.count; ++i)
+        {
+            if (intersects(m_segments[i].a, m_segments[i].b, lowerLeft, upperRight))
+                return false;
+        }
+    }
+    return true;
+}
+
+float LabelPolygon::signedDistance(const glm::vec2 & point) const
+{
+    if (m_nodes.empty())
+        return -std::numeric_limits<float>::max();
+
+    auto best = std::numeric_limits<float>::max();
+
+    Stack stack;
+    auto top = std::size_t(0);
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        const auto & node = m_nodes[stack[--top]];
+        if (squaredBoxDistance(point, node.lowerLeft, node.upperRight) >= best)
+            continue;
+
+        if (node.count == 0)
+        {
+            // visit the nearer child first, i.e., push it last
+            const auto & left = m_nodes[node.first];
+            const auto & right = m_nodes[node.first + 1];
+            const auto leftFirst = squaredBoxDistance(point, left.lowerLeft, left.upperRight)
+                <= squaredBoxDistance(point, right.lowerLeft, right.upperRight);
+            stack[top++] = leftFirst ? node.first + 1 : node.first;
+            stack[top++] = leftFirst ? node.first : node.first + 1;
+            continue;
+        }
+
+        for (auto i = node.first; i < node.first + node.count; ++i)
+            best = glm::min(best, squaredDistance(point, m_segments[i].a, m_segments[i].b));
+    }
+
+    const auto distance = std::sqrt(best);
+    return contains(point) ? distance : -distance;
+}
+
+glm::vec2 LabelPolygon::poleOfInaccessibility(const float precision, float * distance) const
+{
+    if (m_nodes.empty())
+    {
+        if (distance)
+            *distance = 0.f;
+        return glm::vec2(0.f);
+    }
+
+    const auto & lowerLeft = m_nodes.front().lowerLeft;
+    const auto & upperRight = m_nodes.front().upperRight;
+    const auto size = glm::min(upperRight.x - lowerLeft.x, upperRight.y - lowerLeft.y);
+
+    if (size <= 0.f)
+    {
+        if (distance)
+            *distance = 0.f;
+        return lowerLeft;
+    }
+
+    const auto makeCell = [this](const glm::vec2 & center, float half) -> Cell
+    {
+        const auto d = signedDistance(center);
+        return {center, half, d, d + half * std::sqrt(2.f)};
+    };
+
+    // cover the bounding box with square cells
+    std::priority_queue<Cell> queue;
+    for (auto x = lowerLeft.x; x < upperRight.x; x += size)
+    {
+        for (auto y = lowerLeft.y; y < upperRight.y; y += size)
+            queue.push(makeCell({x + size * 0.5f, y + size * 0.5f}, size * 0.5f));
+    }
+
+    // the area weighted centroid is a good initial guess for compact polygons
+    auto area = 0.f;
+    auto centroid = glm::vec2(0.f);
+    for (const auto & segment : m_segments)
+    {
+        const auto cross = segment.a.x * segment.b.y - segment.b.x * segment.a.y;
+        centroid += (segment.a + segment.b) * cross;
+        area += cross * 3.f;
+    }
+
+    auto best = makeCell((lowerLeft + upperRight) * 0.5f, 0.f);
+    if (area != 0.f)
+    {
+        const auto centroidCell = makeCell(centroid / area, 0.f);
+        if (centroidCell.distance > best.distance)
+            best = centroidCell;
+    }
+
+    while (!queue.empty())
+    {
+        const auto cell = queue.top();
+        queue.pop();
+
+        if (cell.distance > best.distance)
+            best = cell;
+
+        // no point within the cell can improve the result by more than precision
+        if (cell.potential - best.distance <= precision)
+            continue;
+
+        const auto half = cell.half * 0.5f;
+        queue.push(makeCell(cell.center + glm::vec2(-half, -half), half));
+        queue.push(makeCell(cell.center + glm::vec2( half, -half), half));
+        queue.push(makeCell(cell.center + glm::vec2(-half,  half), half));
+        queue.push(makeCell(cell.center + glm::vec2( half,  half), half));
+    }
+
+    if (distance)
+        *distance = best.distance;
+    return best.center;
+}
+
+std::vector<LabelArea> LabelPolygon::candidates(const glm::vec2 & extent, const float precision) const
+{
+    const auto pole = poleOfInaccessibility(precision);
+
+    const std::array<RelativeLabelPosition, 5> positions {{
+        RelativeLabelPosition::Centered,
+        RelativeLabelPosition::UpperRight, RelativeLabelPosition::UpperLeft,
+        RelativeLabelPosition::LowerLeft, RelativeLabelPosition::LowerRight
+    }};
+
+    std::vector<LabelArea> result;
+    for (const auto position : positions)
+    {
+        const auto area = LabelArea{labelOrigin(position, pole, extent), extent, position};
+        if (contains(area))
+            result.push_back(area);
+    }
+
+    if (result.empty())
+        result.push_back({labelOrigin(RelativeLabelPosition::Centered, pole, extent), extent, RelativeLabelPosition::Centered});
+    return result;
+}
+
+
+} // namespace gloperate_text
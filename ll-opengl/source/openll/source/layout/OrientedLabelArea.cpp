@@ -0,0 +1,156 @@
+#include <openll/layout/OrientedLabelArea.h>
+
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+namespace
+{
+
+using Polygon = std::array<glm::vec2, 8>; // a quad clipped by four half planes has at most eight corners
+
+float cross(const glm::vec2 & a, const glm::vec2 & b)
+{
+    return a.x * b.y - a.y * b.x;
+}
+
+// separating axis test along a single axis (not required to be normalized)
+bool separatedAlong(const glm::vec2 & axis, const gloperate_text::OrientedLabelArea & a, const gloperate_text::OrientedLabelArea & b)
+{
+    const auto centerA = a.origin + (a.xAxis + a.yAxis) * 0.5f;
+    const auto centerB = b.origin + (b.xAxis + b.yAxis) * 0.5f;
+
+    const auto distance = std::abs(glm::dot(centerB - centerA, axis));
+    const auto radiusA = (std::abs(glm::dot(a.xAxis, axis)) + std::abs(glm::dot(a.yAxis, axis))) * 0.5f;
+    const auto radiusB = (std::abs(glm::dot(b.xAxis, axis)) + std::abs(glm::dot(b.yAxis, axis))) * 0.5f;
+
+    return distance >= radiusA + radiusB;
+}
+
+bool separated(const gloperate_text::OrientedLabelArea & a, const gloperate_text::OrientedLabelArea & b)
+{
+    return separatedAlong(a.xAxis, a, b) || separatedAlong(a.yAxis, a, b)
+        || separatedAlong(b.xAxis, a, b) || separatedAlong(b.yAxis, a, b);
+}
+
+// corners in counter-clockwise order
+size_t corners(const gloperate_text::OrientedLabelArea & area, Polygon & polygon)
+{
+    polygon[0] = area.origin;
+    polygon[1] = area.origin + area.xAxis;
+    polygon[2] = area.origin + area.xAxis + area.yAxis;
+    polygon[3] = area.origin + area.yAxis;
+
+    if (cross(area.xAxis, area.yAxis) < 0.f)
+        std::swap(polygon[1], polygon[3]);
+
+    return 4;
+}
+
+// Sutherland-Hodgman clipping of a convex polygon against the half plane left of edge (a, b)
+size_t clip(const Polygon & input, size_t count, const glm::vec2 & a, const glm::vec2 & b, Polygon & output)
+{
+    const auto edge = b - a;
+    auto result = size_t(0);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const auto & current = input[i];
+        const auto & next = input[(i + 1) % count];
+
+        const auto currentSide = cross(edge, current - a);
+        const auto nextSide = cross(edge, next - a);
+
+        if (currentSide >= 0.f)
+            output[result++] = current;
+
+        if ((currentSide >= 0.f) != (nextSide >= 0.f))
+            output[result++] = current + (next - current) * (currentSide / (currentSide - nextSide));
+    }
+    return result;
+}
+
+float polygonArea(const Polygon & polygon, size_t count)
+{
+    auto area = 0.f;
+    for (size_t i = 0; i < count; ++i)
+        area += cross(polygon[i], polygon[(i + 1) % count]);
+
+    return std::abs(area) * 0.5f;
+}
+
+}
+
+
+namespace gloperate_text
+{
+
+bool OrientedLabelArea::overlaps(const OrientedLabelArea & other) const
+{
+    // broad phase, also handles hidden labels
+    if (!boundingBox().overlaps(other.boundingBox()))
+        return false;
+    if (isAxisAligned() && other.isAxisAligned())
+        return true;
+    return !separated(*this, other);
+}
+
+bool OrientedLabelArea::paddedOverlaps(const OrientedLabelArea & other, const glm::vec2 & relativePadding) const
+{
+    return padded(relativePadding).overlaps(other.padded(relativePadding));
+}
+
+float OrientedLabelArea::overlapArea(const OrientedLabelArea & other) const
+{
+    const auto box = boundingBox();
+    const auto otherBox = other.boundingBox();
+
+    if (!box.overlaps(otherBox))
+        return 0.f;
+    if (isAxisAligned() && other.isAxisAligned())
+        return box.overlapArea(otherBox);
+
+    Polygon polygon, clipped, clipper;
+    auto count = corners(*this, polygon);
+    corners(other, clipper);
+
+    for (size_t i = 0; i < 4 && count > 0; ++i)
+    {
+        count = clip(polygon, count, clipper[i], clipper[(i + 1) % 4], clipped);
+        polygon = clipped;
+    }
+    return polygonArea(polygon, count);
+}
+
+float OrientedLabelArea::paddedOverlapArea(const OrientedLabelArea & other, const glm::vec2 & relativePadding) const
+{
+    return padded(relativePadding).overlapArea(other.padded(relativePadding));
+}
+
+float OrientedLabelArea::area() const
+{
+    return std::abs(cross(xAxis, yAxis));
+}
+
+bool OrientedLabelArea::isAxisAligned() const
+{
+    return (xAxis.y == 0.f && yAxis.x == 0.f) || (xAxis.x == 0.f && yAxis.y == 0.f);
+}
+
+LabelArea OrientedLabelArea::boundingBox() const
+{
+    const auto lowerLeft = origin + glm::min(xAxis, glm::vec2(0.f)) + glm::min(yAxis, glm::vec2(0.f));
+    const auto upperRight = origin + glm::max(xAxis, glm::vec2(0.f)) + glm::max(yAxis, glm::vec2(0.f));
+    return {lowerLeft, upperRight - lowerLeft, position};
+}
+
+OrientedLabelArea OrientedLabelArea::padded(const glm::vec2 & relativePadding) const
+{
+    return {origin - xAxis * relativePadding.x - yAxis * relativePadding.y,
+        xAxis * (1.f + 2.f * relativePadding.x), yAxis * (1.f + 2.f * relativePadding.y), position};
+}
+
+} // namespace gloperate_text
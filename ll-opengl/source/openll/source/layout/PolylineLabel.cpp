@@ -0,0 +1,180 @@
+#include <openll/layout/PolylineLabel.h>
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <openll/ArcLengthTable.h>
+#include <openll/FontFace.h>
+#include <openll/GlyphSequence.h>
+#include <openll/Typesetter.h>
+
+namespace
+{
+
+// pen position and advance of a depictable glyph in font face space
+struct GlyphSpan
+{
+    float begin;
+    float advance;
+};
+
+// single line pens as placed by Typesetter::typeset for per-glyph transforms (the prefix sums
+// hold these, column pens with fixed pitch included)
+float glyphSpans(const gloperate_text::GlyphSequence & sequence, std::vector<GlyphSpan> & spans)
+{
+    spans.clear();
+    const auto & glyphs = sequence.glyphRun();
+    const auto & advances = sequence.prefixAdvances();
+    for (size_t i = 0; i < glyphs.size(); ++i)
+    {
+        if (glyphs[i].glyph->depictable())
+            spans.push_back({advances[i] + glyphs[i].kerning, glyphs[i].glyph->advance()});
+    }
+    return advances.back();
+}
+
+template <typename Area>
+bool anyOverlap(const gloperate_text::PolylineLabel & label, const Area & other, const glm::vec2 & relativePadding)
+{
+    return std::any_of(label.glyphAreas.begin(), label.glyphAreas.end(),
+        [&](const gloperate_text::OrientedLabelArea & area) { return area.paddedOverlaps(other, relativePadding); });
+}
+
+gloperate_text::PolylineLabel placeGlyphs(const gloperate_text::GlyphSequence & sequence, const gloperate_text::ArcLengthTable & path,
+    const std::vector<GlyphSpan> & spans, float width, float start)
+{
+    const auto & fontFace = *sequence.fontFace();
+    const auto scale = sequence.fontSize() / fontFace.size();
+    const auto length = width * scale;
+
+    const auto anchor = gloperate_text::Typesetter::anchorOffset(sequence);
+    const auto bottom = (fontFace.descent() - anchor) * scale;
+    const auto height = (fontFace.ascent() - fontFace.descent()) * scale;
+
+    // glyphs are placed in reverse order on paths running leftwards to keep the text upright
+    const auto reversed = path.tangent(start + length * 0.5f).x < 0.f;
+
+    gloperate_text::PolylineLabel label;
+    label.start = start;
+    label.curvature = 0.f;
+    label.glyphTransforms.reserve(spans.size());
+    label.glyphAreas.reserve(spans.size());
+
+    auto lowerLeft = glm::vec2(std::numeric_limits<float>::max());
+    auto upperRight = glm::vec2(std::numeric_limits<float>::lowest());
+    auto previousTangent = glm::vec2(0.f);
+
+    for (const auto & span : spans)
+    {
+        const auto center = span.begin + span.advance * 0.5f;
+        const auto arcLength = reversed ? start + length - center * scale : start + center * scale;
+
+        const auto position = path.position(arcLength);
+        const auto tangent = reversed ? -path.tangent(arcLength) : path.tangent(arcLength);
+        const auto normal = glm::vec2(-tangent.y, tangent.x);
+
+        if (!label.glyphAreas.empty())
+            label.curvature = glm::max(label.curvature,
+                std::acos(glm::clamp(glm::dot(previousTangent, tangent), -1.f, 1.f)));
+        previousTangent = tangent;
+
+        // rotate around the glyph's center on the baseline, then move it onto the path
+        auto transform = glm::mat4();
+        transform[0] = glm::vec4(tangent * scale, 0.f, 0.f);
+        transform[1] = glm::vec4(normal * scale, 0.f, 0.f);
+        transform[2] = glm::vec4(0.f, 0.f, scale, 0.f);
+        transform[3] = glm::vec4(position - tangent * (center * scale), 0.f, 1.f);
+        label.glyphTransforms.push_back(transform);
+
+        const auto xAxis = tangent * (span.advance * scale);
+        const auto area = gloperate_text::OrientedLabelArea{position - xAxis * 0.5f + normal * bottom,
+            xAxis, normal * height, gloperate_text::RelativeLabelPosition::UpperRight};
+        label.glyphAreas.push_back(area);
+
+        const auto box = area.boundingBox();
+        lowerLeft = glm::min(lowerLeft, box.origin);
+        upperRight = glm::max(upperRight, box.origin + box.extent);
+    }
+
+    label.bounds = spans.empty()
+        ? gloperate_text::LabelArea{path.position(start), glm::vec2(0.f), gloperate_text::RelativeLabelPosition::Hidden}
+        : gloperate_text::LabelArea{lowerLeft, upperRight - lowerLeft, gloperate_text::RelativeLabelPosition::UpperRight};
+    return label;
+}
+
+}
+
+
+namespace gloperate_text
+{
+
+bool PolylineLabel::overlaps(const OrientedLabelArea & other) const
+{
+    return paddedOverlaps(other, glm::vec2(0.f));
+}
+
+bool PolylineLabel::overlaps(const PolylineLabel & other) const
+{
+    return paddedOverlaps(other, glm::vec2(0.f));
+}
+
+bool PolylineLabel::paddedOverlaps(const OrientedLabelArea & other, const glm::vec2 & relativePadding) const
+{
+    const auto otherBounds = other.padded(relativePadding).boundingBox();
+    if (!bounds.paddedOverlaps(otherBounds, relativePadding))
+        return false;
+
+    return anyOverlap(*this, other, relativePadding);
+}
+
+bool PolylineLabel::paddedOverlaps(const PolylineLabel & other, const glm::vec2 & relativePadding) const
+{
+    if (!bounds.paddedOverlaps(other.bounds, relativePadding))
+        return false;
+
+    return std::any_of(other.glyphAreas.begin(), other.glyphAreas.end(),
+        [&](const OrientedLabelArea & area) { return anyOverlap(*this, area, relativePadding); });
+}
+
+
+namespace layout
+{
+
+PolylineLabel polylineLabel(const GlyphSequence & sequence, const ArcLengthTable & path, float start)
+{
+    std::vector<GlyphSpan> spans;
+    const auto width = glyphSpans(sequence, spans);
+    return placeGlyphs(sequence, path, spans, width, start);
+}
+
+std::vector<PolylineLabel> polylineLabels(const GlyphSequence & sequence, const ArcLengthTable & path,
+    float spacing, float maxAngle)
+{
+    assert(spacing > 0.f);
+
+    std::vector<GlyphSpan> spans;
+    const auto width = glyphSpans(sequence, spans);
+    const auto length = width * sequence.fontSize() / sequence.fontFace()->size();
+
+    std::vector<PolylineLabel> candidates;
+    for (auto start = 0.f; start + length <= path.length(); start += spacing)
+    {
+        auto candidate = placeGlyphs(sequence, path, spans, width, start);
+        if (candidate.curvature <= maxAngle)
+            candidates.push_back(std::move(candidate));
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const PolylineLabel & a, const PolylineLabel & b) {
+        return a.curvature < b.curvature; });
+    return candidates;
+}
+
+}
+
+} // namespace gloperate_text
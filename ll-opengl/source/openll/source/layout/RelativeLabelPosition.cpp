@@ -1,6 +1,7 @@
 #include <openll/layout/RelativeLabelPosition.h>
 
 #include <cassert>
+#include <cmath>
 
 namespace gloperate_text
 {
@@ -14,6 +15,21 @@ glm::vec2 labelOrigin(RelativeLabelPosition position, const glm::vec2 & origin,
     case RelativeLabelPosition::LowerLeft:  return origin - extent;
     case RelativeLabelPosition::LowerRight: return origin - glm::vec2(0.f, extent.y);
     case RelativeLabelPosition::Hidden:     return origin;
+    case RelativeLabelPosition::Centered:   return origin - extent * 0.5f;
+    default: assert(false);
+    }
+}
+
+glm::vec2 labelOrigin(RelativeLabelPosition position, const glm::vec2 & origin, const glm::vec2 & xAxis, const glm::vec2 & yAxis)
+{
+    switch (position)
+    {
+    case RelativeLabelPosition::UpperRight: return origin;
+    case RelativeLabelPosition::UpperLeft:  return origin - xAxis;
+    case RelativeLabelPosition::LowerLeft:  return origin - xAxis - yAxis;
+    case RelativeLabelPosition::LowerRight: return origin - yAxis;
+    case RelativeLabelPosition::Hidden:     return origin;
+    case RelativeLabelPosition::Centered:   return origin - (xAxis + yAxis) * 0.5f;
     default: assert(false);
     }
 }
@@ -26,6 +42,7 @@ bool OPENLL_API isVisible(RelativeLabelPosition position)
 RelativeLabelPosition relativeLabelPosition(const glm::vec2 & offset, const glm::vec2 & extent)
 {
     const auto midpointOffset = offset + extent / 2.f;
+    if (std::abs(midpointOffset.x) <= extent.x * 1e-3f && std::abs(midpointOffset.y) <= extent.y * 1e-3f) return RelativeLabelPosition::Centered;
     if (midpointOffset.x > 0 && midpointOffset.y > 0) return RelativeLabelPosition::UpperRight;
     if (midpointOffset.x < 0 && midpointOffset.y > 0) return RelativeLabelPosition::UpperLeft;
     if (midpointOffset.x < 0 && midpointOffset.y < 0) return RelativeLabelPosition::LowerLeft;
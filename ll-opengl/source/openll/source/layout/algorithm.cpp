@@ -3,11 +3,20 @@
 #include <random>
 #include <algorithm>
 #include <limits>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
 
 #include <openll/GlyphSequence.h>
 #include <openll/FontFace.h>
 #include <openll/layout/layoutbase.h>
 #include <openll/layout/LabelArea.h>
+#include <openll/layout/OrientedLabelArea.h>
 #include <openll/Typesetter.h>
 
 
@@ -63,9 +72,159 @@ struct Index2D
     size_t inner = 0;
 };
 
+// cell of the spatial hash used for duplicate suppression, labels only collide with equal text
+struct TextCell
+{
+    std::uint32_t text;
+    std::int32_t x;
+    std::int32_t y;
+
+    bool operator==(const TextCell & other) const
+    {
+        return text == other.text && x == other.x && y == other.y;
+    }
+};
+
+struct TextCellHash
+{
+    size_t operator()(const TextCell & cell) const
+    {
+        auto hash = static_cast<std::uint64_t>(cell.text) * 0x9E3779B97F4A7C15ull;
+        hash ^= static_cast<std::uint32_t>(cell.x) * 0xC2B2AE3D27D4EB4Full;
+        hash ^= static_cast<std::uint32_t>(cell.y) * 0x165667B19E3779F9ull;
+        return static_cast<size_t>(hash ^ (hash >> 32));
+    }
+};
+
+// label indices ordered by descending priority, stable w.r.t. equal priorities
+std::vector<std::uint32_t> priorityOrder(const std::vector<Label> & labels)
+{
+    std::vector<std::uint32_t> order(labels.size());
+    if (labels.empty())
+        return order;
+
+    const auto bounds = std::minmax_element(labels.begin(), labels.end(), [](const Label & a, const Label & b) {
+        return a.priority < b.priority; });
+    const auto lowest = bounds.first->priority;
+    const auto range = static_cast<size_t>(bounds.second->priority - lowest) + 1;
+
+    // priorities are usually few distinct small values, which allows for a linear counting sort
+    if (range > 4 * labels.size())
+    {
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = static_cast<std::uint32_t>(i);
+        std::stable_sort(order.begin(), order.end(), [&labels](std::uint32_t a, std::uint32_t b) {
+            return labels[a].priority > labels[b].priority; });
+        return order;
+    }
+
+    std::vector<size_t> offsets(range + 1, 0);
+    for (const auto & label : labels)
+        ++offsets[range - (label.priority - lowest)];
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+    for (size_t i = 0; i < labels.size(); ++i)
+        order[offsets[range - 1 - (labels[i].priority - lowest)]++] = static_cast<std::uint32_t>(i);
+    return order;
+}
+
+// labels rotated by their additional transform need oriented label areas
+bool isRotated(const Label & label)
+{
+    const auto & transform = label.sequence.additionalTransform();
+    return transform[0].y != 0.f || transform[1].x != 0.f;
+}
+
+bool anyRotated(const std::vector<Label> & labels)
+{
+    return std::any_of(labels.begin(), labels.end(), isRotated);
+}
+
+glm::vec2 direction(const glm::vec2 & axis, const glm::vec2 & fallback)
+{
+    const auto length = glm::length(axis);
+    return length > 0.f ? axis / length : fallback;
+}
+
+template <typename Area>
+Area labelArea(const Label & label, const glm::vec2 & extent, RelativeLabelPosition position);
+
+template <>
+LabelArea labelArea<LabelArea>(const Label & label, const glm::vec2 & extent, RelativeLabelPosition position)
+{
+    return {labelOrigin(position, label.pointLocation, extent), extent, position};
+}
+
+template <>
+OrientedLabelArea labelArea<OrientedLabelArea>(const Label & label, const glm::vec2 & extent, RelativeLabelPosition position)
+{
+    // the extent is measured along the transformed baseline and its perpendicular
+    const auto & transform = label.sequence.additionalTransform();
+    const auto xAxis = direction(glm::vec2(transform[0]), {1.f, 0.f}) * extent.x;
+    const auto yAxis = direction(glm::vec2(transform[1]), {0.f, 1.f}) * extent.y;
+    return {labelOrigin(position, label.pointLocation, xAxis, yAxis), xAxis, yAxis, position};
+}
+
+template <typename Area>
+Area candidateArea(const LabelArea & candidate);
+
+template <>
+LabelArea candidateArea<LabelArea>(const LabelArea & candidate)
+{
+    return candidate;
+}
+
+template <>
+OrientedLabelArea candidateArea<OrientedLabelArea>(const LabelArea & candidate)
+{
+    return {candidate.origin, {candidate.extent.x, 0.f}, {0.f, candidate.extent.y}, candidate.position};
+}
+
+// extents of the label's own shape followed by its alternative shapes, which are measured together
+std::vector<glm::vec2> shapeExtents(const Label & label)
+{
+    if (label.lineWidths.empty())
+        return { Typesetter::extent(label.sequence) };
+
+    // a negative width stands for the label's own shape
+    auto lineWidths = label.lineWidths;
+    lineWidths.insert(lineWidths.begin(), -1.f);
+    return Typesetter::extents(label.sequence, lineWidths);
+}
+
+// the label's explicit candidates (followed by the hidden position) or the given positions for
+// each of its shapes; lineWidths receives the line width of each area (0 for the label's own shape)
+template <typename Area>
+std::vector<Area> candidateAreas(const Label & label, const std::vector<RelativeLabelPosition> & positions, std::vector<float> & lineWidths)
+{
+    std::vector<Area> result;
+    lineWidths.clear();
+    if (!label.candidates.empty())
+    {
+        for (const auto & candidate : label.candidates)
+            result.push_back(candidateArea<Area>(candidate));
+        result.push_back(labelArea<Area>(label, Typesetter::extent(label.sequence), RelativeLabelPosition::Hidden));
+        lineWidths.resize(result.size(), 0.f);
+        return result;
+    }
+
+    const auto extents = shapeExtents(label);
+    for (const auto & position : positions)
+    {
+        const auto shapes = position == RelativeLabelPosition::Hidden ? size_t(1) : extents.size();
+        for (size_t shape = 0; shape < shapes; ++shape)
+        {
+            result.push_back(labelArea<Area>(label, extents[shape], position));
+            lineWidths.push_back(shape == 0 ? 0.f : label.lineWidths[shape - 1]);
+        }
+    }
+    return result;
+}
+
 // computes a graph in which all overlaps between all possible label positions are stored
 // the graph is returned as an adjacency matrix for quick lookup of all overlapping labels of a given placed labels
-std::vector<std::vector<std::vector<LabelCollision>>> createCollisionGraph(const std::vector<std::vector<LabelArea>>& labelAreas, const glm::vec2 & relativePadding = {0.f, 0.f})
+template <typename Area>
+std::vector<std::vector<std::vector<LabelCollision>>> createCollisionGraph(const std::vector<std::vector<Area>>& labelAreas, const glm::vec2 & relativePadding = {0.f, 0.f})
 {
     std::vector<std::vector<std::vector<LabelCollision>>> collisionGraph;
     collisionGraph.resize(labelAreas.size());
@@ -95,23 +254,21 @@ std::vector<std::vector<std::vector<LabelCollision>>> createCollisionGraph(const
 }
 
 // generate LabelArea objects for all possible label placements
-std::vector<std::vector<LabelArea>> computeLabelAreas(const std::vector<Label> & labels, const std::vector<RelativeLabelPosition>& positions)
+template <typename Area>
+std::vector<std::vector<Area>> computeLabelAreas(const std::vector<Label> & labels, const std::vector<RelativeLabelPosition>& positions,
+    std::vector<std::vector<float>> & lineWidths)
 {
-    std::vector<std::vector<LabelArea>> result;
-    for (const auto & label : labels)
+    std::vector<std::vector<Area>> result;
+    lineWidths.resize(labels.size());
+    for (size_t i = 0; i < labels.size(); ++i)
     {
-        result.push_back({});
-        const auto extent = Typesetter::extent(label.sequence);
-        for (const auto& position : positions)
-        {
-            const auto origin = labelOrigin(position, label.pointLocation, extent);
-            result.back().push_back({origin, extent, position});
-        }
+        result.push_back(candidateAreas<Area>(labels[i], positions, lineWidths[i]));
     }
     return result;
 }
 
-std::vector<unsigned int> randomStartLabelAreas(const std::vector<std::vector<LabelArea>> & labelAreas)
+template <typename Area>
+std::vector<unsigned int> randomStartLabelAreas(const std::vector<std::vector<Area>> & labelAreas)
 {
     std::vector<unsigned int> result;
     std::default_random_engine generator;
@@ -134,7 +291,8 @@ T randomIndexExcept(T except, T size, std::default_random_engine engine)
     return randomNumber;
 }
 
-float computePenalty(const LabelArea & labelArea, const std::vector<LabelCollision> & collisions,
+template <typename Area>
+float computePenalty(const Area & labelArea, const std::vector<LabelCollision> & collisions,
     unsigned int priority, PenaltyFunction penaltyFunction, const std::vector<unsigned int> & chosenLabels)
 {
     float overlapArea = 0.f;
@@ -150,50 +308,16 @@ float computePenalty(const LabelArea & labelArea, const std::vector<LabelCollisi
     return penaltyFunction(overlapCount, overlapArea, labelArea.position, priority);
 }
 
-LabelPlacement placementFor(const LabelArea & labelArea, const glm::vec2 & pointLocation)
+template <typename Area>
+LabelPlacement placementFor(const Area & labelArea, const glm::vec2 & pointLocation, float lineWidth = 0.f)
 {
     const auto visible = isVisible(labelArea.position);
     const auto position = labelArea.origin - pointLocation;
-    return {position, Alignment::LeftAligned, LineAnchor::Bottom, visible};
-}
-
-}
-
-
-float overlapArea(int, float overlapArea, RelativeLabelPosition, unsigned int)
-{
-    return overlapArea;
-}
-float overlapCount(int overlapCount, float, RelativeLabelPosition, unsigned int)
-{
-    return overlapCount;
-}
-
-float standard(int, float overlapArea, RelativeLabelPosition position, unsigned int priority)
-{
-    unsigned int positionPenalty = 0;
-    switch (position)
-    {
-        case RelativeLabelPosition::UpperRight: positionPenalty = 0; break;
-        case RelativeLabelPosition::UpperLeft:  positionPenalty = 1; break;
-        case RelativeLabelPosition::LowerLeft:  positionPenalty = 2; break;
-        case RelativeLabelPosition::LowerRight: positionPenalty = 3; break;
-        case RelativeLabelPosition::Hidden:     return 0.02f * priority * priority;
-        default: assert(false);
-    }
-    return 15.f * overlapArea + .03f * positionPenalty;
+    return {position, Alignment::LeftAligned, LineAnchor::Bottom, visible, lineWidth};
 }
 
-
-void constant(std::vector<Label> & labels)
-{
-    for (auto & label : labels)
-    {
-        label.placement = {{0.f, 0.f}, Alignment::LeftAligned, LineAnchor::Bottom, true};
-    }
-}
-
-void random(std::vector<Label> & labels)
+template <typename Area>
+void randomImpl(std::vector<Label> & labels)
 {
     const std::vector<RelativeLabelPosition> positions {
         RelativeLabelPosition::UpperRight, RelativeLabelPosition::UpperLeft,
@@ -201,36 +325,36 @@ void random(std::vector<Label> & labels)
         RelativeLabelPosition::Hidden
     };
     std::default_random_engine generator;
-    std::uniform_int_distribution<int> distribution(0, positions.size() - 1);
+    std::vector<float> lineWidths;
     for (auto & label : labels)
     {
-        const auto extent = Typesetter::extent(label.sequence);
+        const auto areas = candidateAreas<Area>(label, positions, lineWidths);
+        std::uniform_int_distribution<int> distribution(0, areas.size() - 1);
         const auto index = distribution(generator);
-        const auto origin = labelOrigin(positions[index], label.pointLocation, extent);
-        LabelArea area {origin, extent, positions[index]};
-        label.placement = placementFor(area, label.pointLocation);
+        label.placement = placementFor(areas[index], label.pointLocation, lineWidths[index]);
     }
 }
 
-void greedy(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
+template <typename Area>
+void greedyImpl(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
 {
-    std::vector<LabelArea> labelAreas;
+    std::vector<Area> labelAreas;
     const std::vector<RelativeLabelPosition> positions {
         RelativeLabelPosition::UpperRight, RelativeLabelPosition::UpperLeft,
         RelativeLabelPosition::LowerLeft, RelativeLabelPosition::LowerRight,
         RelativeLabelPosition::Hidden
     };
+    std::vector<float> lineWidths;
     for (auto & label : labels)
     {
-        const auto extent = Typesetter::extent(label.sequence);
         float bestPenalty = std::numeric_limits<float>::max();
-        glm::vec2 bestOrigin;
-        LabelArea bestLabelArea;
+        Area bestLabelArea;
+        float bestLineWidth = 0.f;
         // find best position for new label
-        for (const auto& position : positions)
+        const auto candidates = candidateAreas<Area>(label, positions, lineWidths);
+        for (size_t candidate = 0; candidate < candidates.size(); ++candidate)
         {
-            const auto origin = labelOrigin(position, label.pointLocation, extent);
-            const LabelArea newLabelArea {origin, extent, position};
+            const auto & newLabelArea = candidates[candidate];
             float overlapArea = 0.f;
             int overlapCount = 0;
             for (const auto& other : labelAreas)
@@ -239,19 +363,21 @@ void greedy(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const
                 overlapCount += newLabelArea.paddedOverlaps(other, relativePadding) ? 1 : 0;
             }
             overlapArea /= newLabelArea.area();
-            auto penalty = penaltyFunction(overlapCount, overlapArea, position, label.priority);
+            auto penalty = penaltyFunction(overlapCount, overlapArea, newLabelArea.position, label.priority);
             if (penalty < bestPenalty)
             {
                 bestPenalty = penalty;
                 bestLabelArea = newLabelArea;
+                bestLineWidth = lineWidths[candidate];
             }
         }
-        label.placement = placementFor(bestLabelArea, label.pointLocation);
+        label.placement = placementFor(bestLabelArea, label.pointLocation, bestLineWidth);
         labelAreas.push_back(bestLabelArea);
     }
 }
 
-void discreteGradientDescent(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
+template <typename Area>
+void discreteGradientDescentImpl(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
 {
     const std::vector<RelativeLabelPosition> positions {
         RelativeLabelPosition::UpperRight, RelativeLabelPosition::UpperLeft,
@@ -259,7 +385,8 @@ void discreteGradientDescent(std::vector<Label> & labels, PenaltyFunction penalt
         RelativeLabelPosition::Hidden
     };
 
-    const std::vector<std::vector<LabelArea>> labelAreas = computeLabelAreas(labels, positions);
+    std::vector<std::vector<float>> lineWidths;
+    const std::vector<std::vector<Area>> labelAreas = computeLabelAreas<Area>(labels, positions, lineWidths);
     std::vector<unsigned int> chosenLabels = randomStartLabelAreas(labelAreas);
     const auto collisionGraph = createCollisionGraph(labelAreas, relativePadding);
     const auto chosenLabel = [&](unsigned int i) { return labelAreas[i][chosenLabels[i]]; };
@@ -310,11 +437,12 @@ void discreteGradientDescent(std::vector<Label> & labels, PenaltyFunction penalt
 
     for (size_t i = 0; i < labels.size(); ++i)
     {
-        labels[i].placement = placementFor(chosenLabel(i), labels[i].pointLocation);
+        labels[i].placement = placementFor(chosenLabel(i), labels[i].pointLocation, lineWidths[i][chosenLabels[i]]);
     }
 }
 
-void simulatedAnnealing(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
+template <typename Area>
+void simulatedAnnealingImpl(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
 {
     // based on https://www.eecs.harvard.edu/shieber/Biblio/Papers/tog-final.pdf
 
@@ -324,7 +452,8 @@ void simulatedAnnealing(std::vector<Label> & labels, PenaltyFunction penaltyFunc
         RelativeLabelPosition::Hidden
     };
 
-    const std::vector<std::vector<LabelArea>> labelAreas = computeLabelAreas(labels, positions);
+    std::vector<std::vector<float>> lineWidths;
+    const std::vector<std::vector<Area>> labelAreas = computeLabelAreas<Area>(labels, positions, lineWidths);
     std::vector<unsigned int> chosenLabels = randomStartLabelAreas(labelAreas);
     const auto collisionGraph = createCollisionGraph(labelAreas, relativePadding);
     const auto chosenLabel = [&](unsigned int i) { return labelAreas[i][chosenLabels[i]]; };
@@ -388,7 +517,306 @@ void simulatedAnnealing(std::vector<Label> & labels, PenaltyFunction penaltyFunc
 
     for (size_t i = 0; i < labels.size(); ++i)
     {
-        labels[i].placement = placementFor(chosenLabel(i), labels[i].pointLocation);
+        labels[i].placement = placementFor(chosenLabel(i), labels[i].pointLocation, lineWidths[i][chosenLabels[i]]);
+    }
+}
+
+}
+
+
+float overlapArea(int, float overlapArea, RelativeLabelPosition, unsigned int)
+{
+    return overlapArea;
+}
+float overlapCount(int overlapCount, float, RelativeLabelPosition, unsigned int)
+{
+    return overlapCount;
+}
+
+float standard(int, float overlapArea, RelativeLabelPosition position, unsigned int priority)
+{
+    unsigned int positionPenalty = 0;
+    switch (position)
+    {
+        case RelativeLabelPosition::UpperRight: positionPenalty = 0; break;
+        case RelativeLabelPosition::UpperLeft:  positionPenalty = 1; break;
+        case RelativeLabelPosition::LowerLeft:  positionPenalty = 2; break;
+        case RelativeLabelPosition::LowerRight: positionPenalty = 3; break;
+        case RelativeLabelPosition::Hidden:     return 0.02f * priority * priority;
+        case RelativeLabelPosition::Centered:   positionPenalty = 0; break;
+        default: assert(false);
+    }
+    return 15.f * overlapArea + .03f * positionPenalty;
+}
+
+
+void suppressDuplicates(std::vector<Label> & labels, float minDistance)
+{
+    if (labels.size() < 2 || !(minDistance > 0.f))
+        return;
+
+    // intern texts so that the spatial hash works on integers
+    std::unordered_map<std::u32string, std::uint32_t> texts;
+    texts.reserve(labels.size());
+    std::vector<std::uint32_t> textIds(labels.size());
+    for (size_t i = 0; i < labels.size(); ++i)
+        textIds[i] = texts.emplace(labels[i].sequence.string(), static_cast<std::uint32_t>(texts.size())).first->second;
+
+    if (texts.size() == labels.size())
+        return;
+
+    // cells of size minDistance, so that only the 3x3 neighborhood needs to be checked;
+    // each cell stores a list of kept labels, linked via next
+    const auto invalid = std::numeric_limits<std::uint32_t>::max();
+    std::unordered_map<TextCell, std::uint32_t, TextCellHash> cells;
+    cells.reserve(labels.size());
+    std::vector<std::uint32_t> next(labels.size(), invalid);
+    std::vector<bool> keep(labels.size(), false);
+
+    const auto cellOf = [minDistance](const glm::vec2 & location) {
+        return glm::ivec2(std::floor(location.x / minDistance), std::floor(location.y / minDistance)); };
+    const auto squaredDistance = minDistance * minDistance;
+
+    for (const auto i : priorityOrder(labels))
+    {
+        const auto & location = labels[i].pointLocation;
+        const auto cell = cellOf(location);
+
+        auto duplicate = false;
+        for (auto y = cell.y - 1; y <= cell.y + 1 && !duplicate; ++y)
+        {
+            for (auto x = cell.x - 1; x <= cell.x + 1 && !duplicate; ++x)
+            {
+                const auto found = cells.find({textIds[i], x, y});
+                if (found == cells.end())
+                    continue;
+
+                for (auto j = found->second; j != invalid && !duplicate; j = next[j])
+                {
+                    const auto delta = labels[j].pointLocation - location;
+                    duplicate = glm::dot(delta, delta) < squaredDistance;
+                }
+            }
+        }
+        if (duplicate)
+            continue;
+
+        keep[i] = true;
+        auto & head = cells.emplace(TextCell{textIds[i], cell.x, cell.y}, invalid).first->second;
+        next[i] = head;
+        head = i;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < labels.size(); ++i)
+    {
+        if (!keep[i])
+            continue;
+        if (kept != i)
+            labels[kept] = std::move(labels[i]);
+        ++kept;
+    }
+    labels.erase(labels.begin() + kept, labels.end());
+}
+
+void constant(std::vector<Label> & labels)
+{
+    for (auto & label : labels)
+    {
+        label.placement = {{0.f, 0.f}, Alignment::LeftAligned, LineAnchor::Bottom, true, 0.f};
+    }
+}
+
+void random(std::vector<Label> & labels)
+{
+    if (anyRotated(labels))
+        randomImpl<OrientedLabelArea>(labels);
+    else
+        randomImpl<LabelArea>(labels);
+}
+
+void greedy(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
+{
+    if (anyRotated(labels))
+        greedyImpl<OrientedLabelArea>(labels, penaltyFunction, relativePadding);
+    else
+        greedyImpl<LabelArea>(labels, penaltyFunction, relativePadding);
+}
+
+void discreteGradientDescent(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
+{
+    if (anyRotated(labels))
+        discreteGradientDescentImpl<OrientedLabelArea>(labels, penaltyFunction, relativePadding);
+    else
+        discreteGradientDescentImpl<LabelArea>(labels, penaltyFunction, relativePadding);
+}
+
+void simulatedAnnealing(std::vector<Label> & labels, PenaltyFunction penaltyFunction, const glm::vec2 & relativePadding)
+{
+    if (anyRotated(labels))
+        simulatedAnnealingImpl<OrientedLabelArea>(labels, penaltyFunction, relativePadding);
+    else
+        simulatedAnnealingImpl<LabelArea>(labels, penaltyFunction, relativePadding);
+}
+
+void forceDirected(std::vector<Label> & labels, std::vector<LeaderLine> & leaderLines, const glm::vec2 & relativePadding, unsigned int iterations)
+{
+    leaderLines.clear();
+    if (labels.empty())
+        return;
+
+    // labels are moved as (bounding) boxes, starting in the upper right position
+    std::vector<OrientedLabelArea> areas;
+    std::vector<glm::vec2> homes;       // box centers at the start position
+    std::vector<glm::vec2> halfExtents; // padded
+    std::vector<float> weights;         // labels with higher priority move less
+    areas.reserve(labels.size());
+    homes.reserve(labels.size());
+    halfExtents.reserve(labels.size());
+    weights.reserve(labels.size());
+
+    for (const auto & label : labels)
+    {
+        const auto extent = Typesetter::extent(label.sequence);
+        areas.push_back(labelArea<OrientedLabelArea>(label, extent, RelativeLabelPosition::UpperRight));
+
+        const auto box = areas.back().boundingBox();
+        homes.push_back(box.origin + box.extent * 0.5f);
+        halfExtents.push_back(box.extent * (0.5f + relativePadding));
+        weights.push_back(1.f / (1.f + label.priority));
+    }
+
+    // cells are sized by the median box, so that a few large labels do not put all labels into
+    // the same cells; each label is entered into every cell its box covers instead
+    auto cellSize = glm::vec2(0.f);
+    {
+        std::vector<float> sizes(labels.size());
+        const auto median = sizes.begin() + sizes.size() / 2;
+        for (auto axis = 0; axis < 2; ++axis)
+        {
+            for (size_t i = 0; i < labels.size(); ++i)
+                sizes[i] = halfExtents[i][axis] * 2.f;
+            std::nth_element(sizes.begin(), median, sizes.end());
+            cellSize[axis] = glm::max(*median, std::numeric_limits<float>::epsilon());
+        }
+    }
+
+    auto centers = homes;
+    std::vector<glm::vec2> forces(labels.size());
+    std::vector<size_t> cellOffsets;
+    std::vector<std::uint32_t> cellEntries;
+    std::vector<glm::ivec4> cellRanges(labels.size()); // lower left and upper right cell of each box
+
+    const auto attraction = 0.01f;
+    for (unsigned int iteration = 0; iteration < iterations; ++iteration)
+    {
+        // counting sort of the labels into a uniform grid over the current boxes
+        auto lowerLeft = centers.front() - halfExtents.front();
+        auto upperRight = centers.front() + halfExtents.front();
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            lowerLeft = glm::min(lowerLeft, centers[i] - halfExtents[i]);
+            upperRight = glm::max(upperRight, centers[i] + halfExtents[i]);
+        }
+
+        auto size = cellSize;
+        auto dimensions = glm::ivec2((upperRight - lowerLeft) / size) + 1;
+        const auto maxCells = 4.f * labels.size() + 16.f;
+        if (static_cast<float>(dimensions.x) * dimensions.y > maxCells)
+        {
+            size *= std::sqrt(static_cast<float>(dimensions.x) * dimensions.y / maxCells);
+            dimensions = glm::ivec2((upperRight - lowerLeft) / size) + 1;
+        }
+
+        const auto cellOf = [&](const glm::vec2 & point) {
+            return glm::clamp(glm::ivec2((point - lowerLeft) / size), glm::ivec2(0), dimensions - 1); };
+
+        cellOffsets.assign(static_cast<size_t>(dimensions.x) * dimensions.y + 1, 0);
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            const auto first = cellOf(centers[i] - halfExtents[i]);
+            const auto last = cellOf(centers[i] + halfExtents[i]);
+            cellRanges[i] = glm::ivec4(first, last);
+
+            for (auto y = first.y; y <= last.y; ++y)
+            {
+                for (auto x = first.x; x <= last.x; ++x)
+                    ++cellOffsets[static_cast<size_t>(y * dimensions.x + x) + 1];
+            }
+        }
+        for (size_t i = 1; i < cellOffsets.size(); ++i)
+            cellOffsets[i] += cellOffsets[i - 1];
+        {
+            cellEntries.resize(cellOffsets.back());
+            auto fill = cellOffsets;
+            for (size_t i = 0; i < labels.size(); ++i)
+            {
+                const auto & range = cellRanges[i];
+                for (auto y = range.y; y <= range.w; ++y)
+                {
+                    for (auto x = range.x; x <= range.z; ++x)
+                        cellEntries[fill[static_cast<size_t>(y * dimensions.x + x)]++] = static_cast<std::uint32_t>(i);
+                }
+            }
+        }
+
+        // pull back to the start position
+        for (size_t i = 0; i < labels.size(); ++i)
+            forces[i] = (homes[i] - centers[i]) * attraction;
+
+        // push overlapping boxes apart along the axis of least penetration; boxes sharing several
+        // cells are handled once, in the cell of their intersection's lower left
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            const auto & range = cellRanges[i];
+            for (auto y = range.y; y <= range.w; ++y)
+            {
+                for (auto x = range.x; x <= range.z; ++x)
+                {
+                    const auto index = static_cast<size_t>(y * dimensions.x + x);
+                    for (auto entry = cellOffsets[index]; entry < cellOffsets[index + 1]; ++entry)
+                    {
+                        const auto j = cellEntries[entry];
+                        if (j <= i)
+                            continue;
+
+                        const auto delta = centers[j] - centers[i];
+                        const auto penetration = halfExtents[i] + halfExtents[j] - glm::abs(delta);
+                        if (penetration.x <= 0.f || penetration.y <= 0.f)
+                            continue;
+
+                        const auto intersection = glm::max(centers[i] - halfExtents[i], centers[j] - halfExtents[j]);
+                        if (cellOf(intersection) != glm::ivec2(x, y))
+                            continue;
+
+                        const auto axis = penetration.x < penetration.y ? 0 : 1;
+                        // coincident labels are separated by index
+                        const auto sign = delta[axis] > 0.f || (delta[axis] == 0.f && (i + j) % 2 == 0) ? 1.f : -1.f;
+                        const auto push = penetration[axis] * sign / (weights[i] + weights[j]);
+                        forces[i][axis] -= push * weights[i];
+                        forces[j][axis] += push * weights[j];
+                    }
+                }
+            }
+        }
+
+        // cool down so that the placement settles
+        const auto step = 1.f - static_cast<float>(iteration) / iterations;
+        for (size_t i = 0; i < labels.size(); ++i)
+            centers[i] += forces[i] * step;
+    }
+
+    for (size_t i = 0; i < labels.size(); ++i)
+    {
+        auto & area = areas[i];
+        area.origin += centers[i] - homes[i];
+        labels[i].placement = placementFor(area, labels[i].pointLocation);
+
+        const auto box = area.boundingBox();
+        const auto & point = labels[i].pointLocation;
+        const auto closest = glm::clamp(point, box.origin, box.origin + box.extent);
+        if (glm::length(closest - point) > glm::length(box.extent * relativePadding))
+            leaderLines.push_back({point, closest});
     }
 }
 
@@ -14,6 +14,11 @@ GlyphSequence applyPlacement(const Label & label)
     auto sequence = label.sequence;
     sequence.setAlignment(label.placement.alignment);
     sequence.setLineAnchor(label.placement.lineAnchor);
+    if (label.placement.lineWidth > 0.f)
+    {
+        sequence.setWordWrap(true);
+        sequence.setLineWidth(label.placement.lineWidth);
+    }
     auto transform = glm::translate(glm::mat4(), glm::vec3(label.placement.offset, 0.f));
     transform *= sequence.additionalTransform();
     sequence.setAdditionalTransform(transform);
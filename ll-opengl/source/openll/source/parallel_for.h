@@ -0,0 +1,66 @@
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+
+namespace gloperate_text
+{
+
+
+// fewer glyphs per worker do not amortize starting a thread
+const auto minGlyphsPerWorker = std::size_t(8192);
+
+// the number of workers for the given number of glyphs, at most one per hardware thread
+inline std::size_t numWorkersFor(const std::size_t numGlyphs)
+{
+    return std::max(std::min(static_cast<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u))
+        , numGlyphs / minGlyphsPerWorker), std::size_t(1));
+}
+
+// calls function(i) for each i in [0, count), distributing chunks of indices among the
+// given number of workers (the calling thread being one of them)
+template <typename Function>
+void parallel_for(
+    const std::size_t count
+,   const std::size_t numWorkers
+,   const Function & function)
+{
+    if (numWorkers < 2)
+    {
+        for (auto i = std::size_t(0); i < count; ++i)
+            function(i);
+        return;
+    }
+
+    // several chunks per worker balance sequences of differing lengths
+    const auto chunkSize = std::max(count / (numWorkers * 8), std::size_t(1));
+    std::atomic<std::size_t> next(0);
+
+    const auto work = [&]()
+    {
+        for (auto begin = next.fetch_add(chunkSize); begin < count; begin = next.fetch_add(chunkSize))
+        {
+            const auto end = std::min(begin + chunkSize, count);
+            for (auto i = begin; i < end; ++i)
+                function(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(numWorkers - 1);
+    for (auto i = std::size_t(1); i < numWorkers; ++i)
+        workers.emplace_back(work);
+
+    work();
+
+    for (auto & worker : workers)
+        worker.join();
+}
+
+
+} // namespace gloperate_text
@@ -0,0 +1,58 @@
+
+#include <gmock/gmock.h>
+
+
+#include <openll/ArcLengthTable.h>
+
+class ArcLengthTable_test: public testing::Test
+{
+public:
+};
+
+TEST_F(ArcLengthTable_test, Lookup)
+{
+    // an L-shaped polyline with a duplicate point
+    gloperate_text::ArcLengthTable table({{0.f, 0.f}, {2.f, 0.f}, {2.f, 0.f}, {2.f, 3.f}});
+    EXPECT_EQ(3u, table.points().size());
+    EXPECT_FLOAT_EQ(5.f, table.length());
+
+    EXPECT_EQ(0u, table.segment(1.f));
+    EXPECT_EQ(1u, table.segment(2.5f));
+    EXPECT_EQ(1u, table.segment(7.f));
+
+    EXPECT_FLOAT_EQ(1.f, table.position(1.f).x);
+    EXPECT_FLOAT_EQ(0.f, table.position(1.f).y);
+    EXPECT_FLOAT_EQ(2.f, table.position(4.f).x);
+    EXPECT_FLOAT_EQ(2.f, table.position(4.f).y);
+    EXPECT_FLOAT_EQ(0.f, table.position(-1.f).x);
+    EXPECT_FLOAT_EQ(3.f, table.position(7.f).y);
+
+    EXPECT_FLOAT_EQ(1.f, table.tangent(1.f).x);
+    EXPECT_FLOAT_EQ(1.f, table.tangent(4.f).y);
+
+    // searching from any segment finds the same one
+    for (auto arcLength = -1.f; arcLength < 7.f; arcLength += 0.5f)
+    {
+        EXPECT_EQ(table.segment(arcLength), table.segment(arcLength, 0));
+        EXPECT_EQ(table.segment(arcLength), table.segment(arcLength, 1));
+        EXPECT_EQ(table.segment(arcLength), table.segment(arcLength, 5));
+    }
+    EXPECT_FLOAT_EQ(-1.f, table.position(-1.f, 0).x);
+    EXPECT_FLOAT_EQ(5.f, table.position(7.f, 1).y);
+}
+
+TEST_F(ArcLengthTable_test, CubicBezier)
+{
+    // a straight piece followed by a quarter circle approximation
+    const auto k = 0.5523f;
+    const auto table = gloperate_text::ArcLengthTable::cubicBezier({{0.f, 0.f}, {1.f, 0.f}, {2.f, 0.f}, {3.f, 0.f},
+        {3.f + k, 0.f}, {4.f, 1.f - k}, {4.f, 1.f}}, 32);
+
+    EXPECT_EQ(65u, table.points().size());
+    EXPECT_NEAR(3.f + 3.14159265f * 0.5f, table.length(), 1e-3f);
+
+    EXPECT_FLOAT_EQ(1.5f, table.position(1.5f).x);
+    EXPECT_NEAR(4.f, table.position(table.length()).x, 1e-5f);
+    EXPECT_NEAR(1.f, table.position(table.length()).y, 1e-5f);
+    EXPECT_NEAR(1.f, table.tangent(table.length()).y, 1e-2f);
+}
@@ -0,0 +1,57 @@
+
+#include <gmock/gmock.h>
+
+#include <string>
+
+#include <openll/ExtentCache.h>
+
+class ExtentCache_test: public testing::Test
+{
+public:
+};
+
+TEST_F(ExtentCache_test, LeastRecentlyUsedEviction)
+{
+    gloperate_text::ExtentCache cache(2);
+    auto extent = glm::vec2(0.f);
+
+    EXPECT_FALSE(cache.find(U"a", nullptr, -1.f, extent));
+    cache.insert(U"a", nullptr, -1.f, {1.f, 2.f});
+    cache.insert(U"a", nullptr, 100.f, {3.f, 4.f});
+
+    EXPECT_TRUE(cache.find(U"a", nullptr, -1.f, extent));
+    EXPECT_FLOAT_EQ(1.f, extent.x);
+    EXPECT_FLOAT_EQ(2.f, extent.y);
+
+    // evicts the entry with line width 100, which was used less recently
+    cache.insert(U"b", nullptr, -1.f, {5.f, 6.f});
+    EXPECT_EQ(2u, cache.size());
+    EXPECT_FALSE(cache.find(U"a", nullptr, 100.f, extent));
+    EXPECT_TRUE(cache.find(U"a", nullptr, -1.f, extent));
+    EXPECT_TRUE(cache.find(U"b", nullptr, -1.f, extent));
+    EXPECT_FLOAT_EQ(5.f, extent.x);
+
+    EXPECT_EQ(3u, cache.hits());
+    EXPECT_EQ(2u, cache.misses());
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST_F(ExtentCache_test, EntriesOwnTheirStrings)
+{
+    gloperate_text::ExtentCache cache(4);
+    auto extent = glm::vec2(0.f);
+
+    // short and long (heap allocated) strings, modified by the caller after insertion
+    for (const auto length : { 3u, 300u })
+    {
+        auto string = std::u32string(length, U'x');
+        cache.insert(string, nullptr, -1.f, {static_cast<float>(length), 1.f});
+        string[0] = U'y';
+
+        EXPECT_FALSE(cache.find(string, nullptr, -1.f, extent));
+        EXPECT_TRUE(cache.find(std::u32string(length, U'x'), nullptr, -1.f, extent));
+        EXPECT_FLOAT_EQ(static_cast<float>(length), extent.x);
+    }
+}
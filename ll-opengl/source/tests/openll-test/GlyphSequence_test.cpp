@@ -0,0 +1,45 @@
+
+#include <gmock/gmock.h>
+
+#include <string>
+
+#include <openll/GlyphSequence.h>
+
+class GlyphSequence_test: public testing::Test
+{
+public:
+};
+
+TEST_F(GlyphSequence_test, Utf8MatchesUtf32)
+{
+    // blocks of ASCII, with multi-byte sequences within and across block boundaries
+    const auto utf8 = std::string(u8"Straße am See, 日本語 und \U0001F600 — Ende")
+        + std::string(40, 'x') + std::string(u8"ä");
+    const auto utf32 = std::u32string(U"Straße am See, 日本語 und \U0001F600 — Ende")
+        + std::u32string(40, U'x') + std::u32string(U"ä");
+
+    gloperate_text::GlyphSequence sequence;
+    sequence.setString(utf8);
+    EXPECT_EQ(utf32, sequence.string());
+
+    // setting an equal string is not recorded as edit
+    sequence.resetEdit();
+    sequence.setString(utf8);
+    EXPECT_FALSE(sequence.edited());
+
+    sequence.setString(utf8.substr(0, 4));
+    EXPECT_TRUE(sequence.edited());
+    EXPECT_EQ(utf32.substr(0, 4), sequence.string());
+}
+
+TEST_F(GlyphSequence_test, Utf8ReplacesInvalidSequences)
+{
+    gloperate_text::GlyphSequence sequence;
+
+    // truncated sequence, stray continuation byte, overlong encoding, surrogate, and a code
+    // point beyond U+10FFFF, each replaced by U+FFFD per maximal invalid subpart
+    const char utf8[] = "a\xE6\x97" "b\x80" "c\xC0\xAF" "d\xED\xA0\x80" "e\xF4\x90\x80\x80" "f\xE6\x97";
+    sequence.setString(utf8, sizeof(utf8) - 1);
+
+    EXPECT_EQ(std::u32string(U"a�b�c��d���e����f�"), sequence.string());
+}
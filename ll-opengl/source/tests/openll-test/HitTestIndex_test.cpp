@@ -0,0 +1,235 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/HitTestIndex.h>
+#include <openll/GlyphSequence.h>
+#include <openll/GlyphVertexCloud.h>
+#include <openll/Typesetter.h>
+
+#include "TestFontFace.h"
+
+class HitTestIndex_test: public testing::Test
+{
+public:
+    HitTestIndex_test()
+    {
+        setupTestFontFace(m_fontFace);
+    }
+
+    // sequences placed at random, a third of them rotated
+    void place(gloperate_text::GlyphSequence & sequence, std::mt19937 & random)
+    {
+        const auto position = glm::vec3(static_cast<float>(random() % 2000), static_cast<float>(random() % 2000), 0.f);
+        auto transform = glm::translate(glm::mat4(1.f), position);
+        if (random() % 3 == 0)
+            transform = glm::rotate(transform, static_cast<float>(random() % 628) * 0.01f, glm::vec3(0.f, 0.f, 1.f));
+
+        sequence.setAdditionalTransform(transform);
+    }
+
+    void typeset(const std::vector<gloperate_text::GlyphSequence> & sequences, gloperate_text::GlyphVertexCloud & cloud)
+    {
+        auto & vertices = cloud.vertices();
+        vertices.clear();
+        for (const auto & sequence : sequences)
+        {
+            vertices.resize(vertices.size() + sequence.depictableSize());
+            gloperate_text::Typesetter::typeset(sequence, vertices.data() + vertices.size() - sequence.depictableSize());
+        }
+    }
+
+    // the glyph of each vertex
+    std::vector<gloperate_text::HitTestIndex::Hit> glyphs(const std::vector<gloperate_text::GlyphSequence> & sequences)
+    {
+        std::vector<gloperate_text::HitTestIndex::Hit> glyphs;
+        for (size_t s = 0; s < sequences.size(); ++s)
+        {
+            for (size_t i = 0; i < sequences[s].size(); ++i)
+            {
+                if (sequences[s].glyphRun()[i].glyph->depictable())
+                    glyphs.push_back({ s, i });
+            }
+        }
+        return glyphs;
+    }
+
+    static bool contains(const gloperate_text::GlyphVertexCloud::Vertex & vertex, const glm::vec2 & point)
+    {
+        // solve origin + u * vtan + v * vbitan = point
+        const auto d = glm::vec2(point.x - vertex.origin.x, point.y - vertex.origin.y);
+        const auto det = vertex.vtan.x * vertex.vbitan.y - vertex.vtan.y * vertex.vbitan.x;
+        const auto u = (d.x * vertex.vbitan.y - d.y * vertex.vbitan.x) / det;
+        const auto v = (vertex.vtan.x * d.y - vertex.vtan.y * d.x) / det;
+        return u >= 0.f && u <= 1.f && v >= 0.f && v <= 1.f;
+    }
+
+    static std::vector<glm::vec2> corners(const gloperate_text::GlyphVertexCloud::Vertex & vertex)
+    {
+        const auto origin = glm::vec2(vertex.origin.x, vertex.origin.y);
+        const auto tangent = glm::vec2(vertex.vtan.x, vertex.vtan.y);
+        const auto bitangent = glm::vec2(vertex.vbitan.x, vertex.vbitan.y);
+        return { origin, origin + tangent, origin + bitangent, origin + tangent + bitangent };
+    }
+
+    static std::vector<size_t> sorted(const std::vector<gloperate_text::HitTestIndex::Hit> & hits)
+    {
+        std::vector<size_t> keys;
+        for (const auto & hit : hits)
+            keys.push_back(hit.sequence * 1000 + hit.index);
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+protected:
+    gloperate_text::FontFace m_fontFace;
+};
+
+
+TEST_F(HitTestIndex_test, QueriesMatchLinearScan)
+{
+    const auto alphabet = std::u32string(U"abcdefghijklmnopqrstuvwxyz   ");
+    std::mt19937 random(11);
+
+    std::vector<gloperate_text::GlyphSequence> sequences(300);
+    for (auto & sequence : sequences)
+    {
+        auto string = std::u32string();
+        for (auto i = random() % 24; i > 0; --i)
+            string += alphabet[random() % alphabet.size()];
+
+        sequence.setString(string);
+        sequence.setFontFace(&m_fontFace);
+        sequence.setFontSize(12.f + static_cast<float>(random() % 24));
+        place(sequence, random);
+    }
+
+    gloperate_text::GlyphVertexCloud cloud;
+    typeset(sequences, cloud);
+
+    gloperate_text::HitTestIndex index;
+    index.build(sequences, cloud);
+
+    for (auto step = 0; step < 4; ++step)
+    {
+        const auto & vertices = cloud.vertices();
+        const auto all = glyphs(sequences);
+        ASSERT_EQ(all.size(), vertices.size());
+
+        std::vector<gloperate_text::HitTestIndex::Hit> hits;
+        std::vector<gloperate_text::HitTestIndex::Hit> expected;
+
+        // points within glyphs of the cloud as well as anywhere
+        for (auto i = 0; i < 400; ++i)
+        {
+            auto point = glm::vec2(static_cast<float>(random() % 2100), static_cast<float>(random() % 2100));
+            if (i % 2 == 0)
+            {
+                const auto & vertex = vertices[random() % vertices.size()];
+                point = glm::vec2(vertex.origin.x, vertex.origin.y) + 0.5f * glm::vec2(vertex.vtan.x + vertex.vbitan.x, vertex.vtan.y + vertex.vbitan.y);
+            }
+
+            expected.clear();
+            for (size_t v = 0; v < vertices.size(); ++v)
+            {
+                if (contains(vertices[v], point))
+                    expected.push_back(all[v]);
+            }
+
+            index.glyphsAt(point, hits);
+            EXPECT_EQ(sorted(expected), sorted(hits));
+            if (i % 2 == 0)
+            {
+                EXPECT_FALSE(hits.empty());
+            }
+        }
+
+        // glyphs with a corner within the rectangle or containing one of its corners are hit,
+        // and all hits are glyphs whose bounds intersect the rectangle
+        std::vector<size_t> sequenceHits;
+        for (auto i = 0; i < 100; ++i)
+        {
+            const auto lowerLeft = glm::vec2(static_cast<float>(random() % 2000), static_cast<float>(random() % 2000));
+            const auto upperRight = lowerLeft + glm::vec2(static_cast<float>(random() % 200), static_cast<float>(random() % 200));
+            const auto inside = [&](const glm::vec2 & p)
+                { return p.x >= lowerLeft.x && p.x <= upperRight.x && p.y >= lowerLeft.y && p.y <= upperRight.y; };
+
+            index.glyphsWithin(lowerLeft, upperRight, hits);
+            const auto keys = sorted(hits);
+
+            auto sequenceBounds = std::vector<std::pair<glm::vec2, glm::vec2>>(sequences.size()
+                , { glm::vec2(std::numeric_limits<float>::max()), glm::vec2(std::numeric_limits<float>::lowest()) });
+            for (size_t v = 0; v < vertices.size(); ++v)
+            {
+                const auto quad = corners(vertices[v]);
+                auto lower = quad[0];
+                auto upper = quad[0];
+                for (const auto & corner : quad)
+                {
+                    lower = glm::vec2(std::min(lower.x, corner.x), std::min(lower.y, corner.y));
+                    upper = glm::vec2(std::max(upper.x, corner.x), std::max(upper.y, corner.y));
+                }
+
+                const auto key = all[v].sequence * 1000 + all[v].index;
+                const auto hit = std::binary_search(keys.begin(), keys.end(), key);
+
+                const auto bounded = lower.x <= upperRight.x && upper.x >= lowerLeft.x && lower.y <= upperRight.y && upper.y >= lowerLeft.y;
+
+                const auto touching = std::any_of(quad.begin(), quad.end(), inside)
+                    || contains(vertices[v], lowerLeft) || contains(vertices[v], upperRight)
+                    || contains(vertices[v], glm::vec2(lowerLeft.x, upperRight.y)) || contains(vertices[v], glm::vec2(upperRight.x, lowerLeft.y));
+                if (touching)
+                {
+                    EXPECT_TRUE(hit);
+                }
+                if (hit)
+                {
+                    EXPECT_TRUE(bounded);
+                }
+
+                sequenceBounds[all[v].sequence].first = glm::vec2(std::min(sequenceBounds[all[v].sequence].first.x, lower.x)
+                    , std::min(sequenceBounds[all[v].sequence].first.y, lower.y));
+                sequenceBounds[all[v].sequence].second = glm::vec2(std::max(sequenceBounds[all[v].sequence].second.x, upper.x)
+                    , std::max(sequenceBounds[all[v].sequence].second.y, upper.y));
+            }
+
+            // sequences are hit by the bounds of all their glyphs
+            std::vector<size_t> expectedSequences;
+            for (size_t s = 0; s < sequences.size(); ++s)
+            {
+                const auto & bounds = sequenceBounds[s];
+                if (bounds.first.x <= upperRight.x && bounds.second.x >= lowerLeft.x && bounds.first.y <= upperRight.y && bounds.second.y >= lowerLeft.y)
+                    expectedSequences.push_back(s);
+
+                EXPECT_NEAR(bounds.first.x, index.bounds(s).first.x, 1e-3f);
+                EXPECT_NEAR(bounds.second.y, index.bounds(s).second.y, 1e-3f);
+            }
+
+            index.sequencesWithin(lowerLeft, upperRight, sequenceHits);
+            std::sort(sequenceHits.begin(), sequenceHits.end());
+            EXPECT_EQ(expectedSequences, sequenceHits);
+        }
+
+        // move some sequences and change the strings of others, then update incrementally
+        for (auto i = 0; i < 20; ++i)
+            place(sequences[random() % sequences.size()], random);
+        if (step % 2 == 1)
+            sequences[random() % sequences.size()].append(U"xyz");
+
+        typeset(sequences, cloud);
+        index.update(sequences, cloud);
+        ASSERT_EQ(sequences.size(), index.size());
+    }
+}
@@ -0,0 +1,121 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <openll/layout/LabelClusterIndex.h>
+#include <openll/layout/layoutbase.h>
+
+class LabelClusterIndex_test: public testing::Test
+{
+public:
+    LabelClusterIndex_test()
+    {
+        // two groups of nearby labels and a single one far away from both
+        add(U"a1", {0.f, 0.f}, 1);
+        add(U"a2", {0.01f, 0.f}, 5);
+        add(U"a3", {0.f, 0.01f}, 2);
+        add(U"b1", {0.5f, 0.5f}, 3);
+        add(U"b2", {0.51f, 0.5f}, 4);
+        add(U"c", {-0.5f, 0.8f}, 0);
+    }
+
+    void add(const std::u32string & name, const glm::vec2 & location, unsigned int priority)
+    {
+        gloperate_text::Label label;
+        label.sequence.setString(name);
+        label.pointLocation = location;
+        label.priority = priority;
+        m_labels.push_back(label);
+    }
+
+    static std::vector<std::u32string> names(const std::vector<gloperate_text::Label> & labels)
+    {
+        std::vector<std::u32string> names;
+        for (const auto & label : labels)
+            names.push_back(label.sequence.string());
+        std::sort(names.begin(), names.end());
+        return names;
+    }
+
+protected:
+    std::vector<gloperate_text::Label> m_labels;
+};
+
+TEST_F(LabelClusterIndex_test, ClustersPerZoomLevel)
+{
+    gloperate_text::LabelClusterIndex index(0.05f, 0, 4);
+    index.build(m_labels);
+
+    // the radius halves per zoom level, so the groups fall apart at the finest levels
+    // (at zoom 2, a3 is beyond the radius of a2, which seeds the group's cluster)
+    EXPECT_EQ(3u, index.size(0));
+    EXPECT_EQ(3u, index.size(1));
+    EXPECT_EQ(4u, index.size(2));
+    EXPECT_EQ(6u, index.size(4));
+    EXPECT_EQ(6u, index.size(5));
+    for (auto zoom = 0u; zoom < 5u; ++zoom)
+        EXPECT_LE(index.size(zoom), index.size(zoom + 1));
+}
+
+TEST_F(LabelClusterIndex_test, AggregatedLabels)
+{
+    gloperate_text::LabelClusterIndex index(0.05f, 0, 4);
+    index.build(m_labels);
+
+    const auto lowerLeft = glm::vec2(-1.f);
+    const auto upperRight = glm::vec2(1.f);
+
+    // an aggregate shows its highest priority label at the centroid of its labels
+    const auto top = index.query(m_labels, lowerLeft, upperRight, 0);
+    ASSERT_EQ(3u, top.size());
+    EXPECT_EQ((std::vector<std::u32string>{ U"a2", U"b2", U"c" }), names(top));
+
+    const auto a = std::find_if(top.begin(), top.end(), [](const gloperate_text::Label & label)
+        { return label.sequence.string() == U"a2"; });
+    EXPECT_EQ(5u, a->priority);
+    EXPECT_NEAR(0.01f / 3.f, a->pointLocation.x, 1e-6f);
+    EXPECT_NEAR(0.01f / 3.f, a->pointLocation.y, 1e-6f);
+
+    // or the number of its labels
+    const auto counts = index.query(m_labels, lowerLeft, upperRight, 0, gloperate_text::ClusterContent::Count);
+    EXPECT_EQ((std::vector<std::u32string>{ U"2", U"3", U"c" }), names(counts));
+}
+
+TEST_F(LabelClusterIndex_test, ViewportFiltering)
+{
+    gloperate_text::LabelClusterIndex index(0.05f, 0, 4);
+    index.build(m_labels);
+
+    // the viewport's edges are inclusive
+    EXPECT_EQ((std::vector<std::u32string>{ U"c" }),
+        names(index.query(m_labels, {-0.5f, 0.8f}, {-0.5f, 0.8f}, 4)));
+    EXPECT_EQ((std::vector<std::u32string>{ U"b1", U"b2" }),
+        names(index.query(m_labels, {0.5f, 0.5f}, {0.51f, 0.6f}, 4)));
+    EXPECT_TRUE(index.query(m_labels, {-0.6f, 0.81f}, {-0.4f, 0.9f}, 4).empty());
+    EXPECT_TRUE(index.query(m_labels, {0.6f, -1.f}, {1.f, 1.f}, 0).empty());
+
+    // aggregates are filtered by their centroid
+    EXPECT_EQ((std::vector<std::u32string>{ U"b2" }),
+        names(index.query(m_labels, {0.5f, 0.5f}, {0.506f, 0.5f}, 0)));
+}
+
+TEST_F(LabelClusterIndex_test, FinestLevelIsUnclustered)
+{
+    gloperate_text::LabelClusterIndex index(0.05f, 0, 4);
+    index.build(m_labels);
+
+    const auto labels = index.query(m_labels, glm::vec2(-1.f), glm::vec2(1.f), 5);
+    ASSERT_EQ(m_labels.size(), labels.size());
+
+    for (const auto & label : labels)
+    {
+        const auto original = std::find_if(m_labels.begin(), m_labels.end(), [&](const gloperate_text::Label & other)
+            { return other.sequence.string() == label.sequence.string(); });
+        ASSERT_NE(m_labels.end(), original);
+        EXPECT_EQ(original->pointLocation, label.pointLocation);
+        EXPECT_EQ(original->priority, label.priority);
+    }
+}
@@ -0,0 +1,146 @@
+
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <vector>
+
+#include <glm/vec2.hpp>
+
+#include <openll/layout/LabelArea.h>
+#include <openll/layout/LabelPolygon.h>
+#include <openll/layout/RelativeLabelPosition.h>
+
+class LabelPolygon_test: public testing::Test
+{
+public:
+    LabelPolygon_test()
+    : m_square({{{0.f, 0.f}, {10.f, 0.f}, {10.f, 10.f}, {0.f, 10.f}}})
+    // arms of width 4 along the x and y axes
+    , m_lShape({{{0.f, 0.f}, {10.f, 0.f}, {10.f, 4.f}, {4.f, 4.f}, {4.f, 10.f}, {0.f, 10.f}}})
+    // a band of width 3 around a square hole, which is oriented clockwise
+    , m_frame({{{0.f, 0.f}, {10.f, 0.f}, {10.f, 10.f}, {0.f, 10.f}}, {{3.f, 3.f}, {3.f, 7.f}, {7.f, 7.f}, {7.f, 3.f}}})
+    {
+    }
+
+    static gloperate_text::LabelArea area(const glm::vec2 & origin, const glm::vec2 & extent)
+    {
+        return {origin, extent, gloperate_text::RelativeLabelPosition::UpperRight};
+    }
+
+protected:
+    gloperate_text::LabelPolygon m_square;
+    gloperate_text::LabelPolygon m_lShape;
+    gloperate_text::LabelPolygon m_frame;
+};
+
+TEST_F(LabelPolygon_test, PoleOfInaccessibility)
+{
+    const auto precision = 0.01f;
+    auto distance = 0.f;
+
+    const auto squarePole = m_square.poleOfInaccessibility(precision, &distance);
+    EXPECT_NEAR(5.f, squarePole.x, 1e-4f);
+    EXPECT_NEAR(5.f, squarePole.y, 1e-4f);
+    EXPECT_NEAR(5.f, distance, 1e-4f);
+
+    // on the diagonal of the corner, equally far from the outer walls and the inner corner
+    const auto lShapeDistance = 4.f * std::sqrt(2.f) / (1.f + std::sqrt(2.f));
+    const auto lShapePole = m_lShape.poleOfInaccessibility(precision, &distance);
+    EXPECT_NEAR(lShapeDistance, distance, precision);
+    EXPECT_NEAR(lShapeDistance, lShapePole.x, 0.1f);
+    EXPECT_NEAR(lShapeDistance, lShapePole.y, 0.1f);
+    EXPECT_NEAR(distance, m_lShape.signedDistance(lShapePole), 1e-5f);
+
+    // in one of the frame's corners, not at the centroid within the hole
+    const auto frameDistance = 3.f * std::sqrt(2.f) / (1.f + std::sqrt(2.f));
+    const auto framePole = m_frame.poleOfInaccessibility(precision, &distance);
+    EXPECT_NEAR(frameDistance, distance, precision);
+    EXPECT_TRUE(m_frame.contains(framePole));
+    const auto corner = glm::vec2(framePole.x < 5.f ? 0.f : 10.f, framePole.y < 5.f ? 0.f : 10.f);
+    EXPECT_NEAR(frameDistance, std::abs(framePole.x - corner.x), 0.1f);
+    EXPECT_NEAR(frameDistance, std::abs(framePole.y - corner.y), 0.1f);
+}
+
+TEST_F(LabelPolygon_test, ContainsPoint)
+{
+    EXPECT_TRUE(m_square.contains(glm::vec2(5.f, 5.f)));
+    EXPECT_TRUE(m_square.contains(glm::vec2(0.001f, 9.999f)));
+    EXPECT_FALSE(m_square.contains(glm::vec2(-0.001f, 5.f)));
+    EXPECT_FALSE(m_square.contains(glm::vec2(5.f, 10.001f)));
+
+    // rays through vertices and along horizontal edges
+    EXPECT_TRUE(m_lShape.contains(glm::vec2(2.f, 4.f)));
+    EXPECT_TRUE(m_lShape.contains(glm::vec2(2.f, 0.5f)));
+    EXPECT_FALSE(m_lShape.contains(glm::vec2(5.f, 5.f)));
+    EXPECT_FALSE(m_lShape.contains(glm::vec2(11.f, 4.f)));
+
+    EXPECT_TRUE(m_frame.contains(glm::vec2(1.5f, 5.f)));
+    EXPECT_FALSE(m_frame.contains(glm::vec2(5.f, 5.f)));
+    EXPECT_FALSE(m_frame.contains(glm::vec2(11.f, 5.f)));
+
+    EXPECT_FALSE(gloperate_text::LabelPolygon({}).contains(glm::vec2(0.f)));
+}
+
+TEST_F(LabelPolygon_test, ContainsArea)
+{
+    EXPECT_TRUE(m_square.contains(area({1.f, 1.f}, {2.f, 2.f})));
+    EXPECT_FALSE(m_square.contains(area({-1.f, -1.f}, {2.f, 2.f})));
+    EXPECT_FALSE(m_square.contains(area({9.f, 1.f}, {2.f, 2.f})));
+
+    // touching the boundary counts as crossing it
+    EXPECT_FALSE(m_square.contains(area({0.f, 1.f}, {2.f, 2.f})));
+    EXPECT_FALSE(m_lShape.contains(area({1.f, 1.f}, {3.f, 3.f})));
+    EXPECT_TRUE(m_lShape.contains(area({1.f, 1.f}, {2.9f, 2.9f})));
+
+    // a corner inside, but reaching into the notch or the hole
+    EXPECT_FALSE(m_lShape.contains(area({1.f, 1.f}, {5.f, 5.f})));
+    EXPECT_FALSE(m_frame.contains(area({1.f, 1.f}, {4.f, 4.f})));
+    EXPECT_FALSE(m_frame.contains(area({2.f, 2.f}, {6.f, 6.f})));
+    EXPECT_TRUE(m_frame.contains(area({1.f, 1.f}, {8.f, 1.5f})));
+}
+
+TEST_F(LabelPolygon_test, SignedDistance)
+{
+    EXPECT_FLOAT_EQ(5.f, m_square.signedDistance({5.f, 5.f}));
+    EXPECT_FLOAT_EQ(1.f, m_square.signedDistance({1.f, 5.f}));
+    EXPECT_FLOAT_EQ(-2.f, m_square.signedDistance({12.f, 5.f}));
+    EXPECT_FLOAT_EQ(-5.f, m_square.signedDistance({13.f, 14.f}));
+
+    // on the boundary
+    EXPECT_FLOAT_EQ(0.f, std::abs(m_square.signedDistance({10.f, 10.f})));
+    EXPECT_FLOAT_EQ(0.f, std::abs(m_square.signedDistance({5.f, 10.f})));
+    EXPECT_FLOAT_EQ(0.f, std::abs(m_lShape.signedDistance({4.f, 7.f})));
+
+    // in the notch, the arms are nearest; inside, the inner corner is
+    EXPECT_FLOAT_EQ(-1.f, m_lShape.signedDistance({5.f, 5.f}));
+    EXPECT_FLOAT_EQ(std::sqrt(2.f), m_lShape.signedDistance({3.f, 3.f}));
+
+    EXPECT_FLOAT_EQ(-2.f, m_frame.signedDistance({5.f, 5.f}));
+    EXPECT_FLOAT_EQ(1.5f, m_frame.signedDistance({1.5f, 5.f}));
+}
+
+TEST_F(LabelPolygon_test, CandidatesStayInside)
+{
+    const auto precision = 0.01f;
+    for (const auto polygon : { &m_square, &m_lShape, &m_frame })
+    {
+        const auto candidates = polygon->candidates({2.f, 1.f}, precision);
+        ASSERT_FALSE(candidates.empty());
+        EXPECT_EQ(gloperate_text::RelativeLabelPosition::Centered, candidates.front().position);
+        for (const auto & candidate : candidates)
+        {
+            EXPECT_TRUE(polygon->contains(candidate));
+            EXPECT_FLOAT_EQ(2.f, candidate.extent.x);
+            EXPECT_FLOAT_EQ(1.f, candidate.extent.y);
+        }
+    }
+
+    // all positions fit into the square
+    EXPECT_EQ(5u, m_square.candidates({2.f, 1.f}, precision).size());
+
+    // if nothing fits, the centered area is kept
+    const auto oversized = m_lShape.candidates({6.f, 6.f}, precision);
+    ASSERT_EQ(1u, oversized.size());
+    EXPECT_EQ(gloperate_text::RelativeLabelPosition::Centered, oversized.front().position);
+    EXPECT_FALSE(m_lShape.contains(oversized.front()));
+}
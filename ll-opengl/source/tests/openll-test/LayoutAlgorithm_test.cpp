@@ -0,0 +1,274 @@
+
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vec2.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/GlyphSequence.h>
+#include <openll/Typesetter.h>
+#include <openll/layout/LabelArea.h>
+#include <openll/layout/RelativeLabelPosition.h>
+#include <openll/layout/algorithm.h>
+#include <openll/layout/layoutbase.h>
+
+#include "TestFontFace.h"
+
+class LayoutAlgorithm_test: public testing::Test
+{
+public:
+    LayoutAlgorithm_test()
+    {
+        setupTestFontFace(m_fontFace);
+    }
+
+    static gloperate_text::Label label(const std::u32string & text, const glm::vec2 & location, unsigned int priority)
+    {
+        gloperate_text::Label label;
+        label.sequence.setString(text);
+        label.pointLocation = location;
+        label.priority = priority;
+        return label;
+    }
+
+    gloperate_text::Label typesetLabel(const std::u32string & text, const glm::vec2 & location, unsigned int priority)
+    {
+        auto result = label(text, location, priority);
+        result.sequence.setFontFace(&m_fontFace);
+        result.sequence.setFontSize(m_fontFace.size());
+        return result;
+    }
+
+    // summed pairwise overlap of the placed labels' boxes
+    static float overlapArea(const std::vector<gloperate_text::Label> & labels)
+    {
+        auto area = 0.f;
+        for (size_t i = 0; i < labels.size(); ++i)
+        {
+            for (size_t j = i + 1; j < labels.size(); ++j)
+            {
+                const auto lowerLeft = glm::max(origin(labels[i]), origin(labels[j]));
+                const auto upperRight = glm::min(
+                    origin(labels[i]) + gloperate_text::Typesetter::extent(labels[i].sequence),
+                    origin(labels[j]) + gloperate_text::Typesetter::extent(labels[j].sequence));
+                const auto overlap = glm::max(upperRight - lowerLeft, glm::vec2(0.f));
+                area += overlap.x * overlap.y;
+            }
+        }
+        return area;
+    }
+
+    static glm::vec2 origin(const gloperate_text::Label & label)
+    {
+        return label.pointLocation + label.placement.offset;
+    }
+
+    // a cluster of overlapping labels, including a large one, and a label far away from them
+    std::vector<gloperate_text::Label> crowdedLabels()
+    {
+        return {
+            typesetLabel(U"Potsdam", {0.f, 0.f}, 1),
+            typesetLabel(U"Babelsberg", {6.f, 4.f}, 0),
+            typesetLabel(U"Werder", {12.f, -6.f}, 2),
+            typesetLabel(U"Caputh", {3.f, 10.f}, 0),
+            typesetLabel(U"Sanssouci Palace and Park", {-30.f, 8.f}, 4),
+            typesetLabel(U"Teltow", {-8.f, -4.f}, 1),
+            typesetLabel(U"Hamburg", {900.f, 900.f}, 0)
+        };
+    }
+
+protected:
+    gloperate_text::FontFace m_fontFace;
+
+    static std::vector<std::pair<std::u32string, unsigned int>> remaining(const std::vector<gloperate_text::Label> & labels)
+    {
+        std::vector<std::pair<std::u32string, unsigned int>> remaining;
+        for (const auto & label : labels)
+            remaining.emplace_back(label.sequence.string(), label.priority);
+        return remaining;
+    }
+};
+
+TEST_F(LayoutAlgorithm_test, DuplicatesKeepHighestPriority)
+{
+    std::vector<gloperate_text::Label> labels = {
+        label(U"Berlin", {0.2f, 0.2f}, 1),
+        label(U"Berlin", {0.5f, 0.4f}, 3),
+        label(U"Berlin", {0.3f, 0.6f}, 2),
+        label(U"Berlin", {0.4f, 0.5f}, 3) // equal priority, but later
+    };
+
+    gloperate_text::layout::suppressDuplicates(labels, 1.f);
+    EXPECT_EQ((std::vector<std::pair<std::u32string, unsigned int>>{ { U"Berlin", 3 } }), remaining(labels));
+    EXPECT_EQ(glm::vec2(0.5f, 0.4f), labels.front().pointLocation);
+}
+
+TEST_F(LayoutAlgorithm_test, DuplicatesAcrossCells)
+{
+    // cells are of the minimum distance's size
+    std::vector<gloperate_text::Label> labels = {
+        label(U"Rhine", {0.9f, 0.5f}, 1),  // within the distance, but in another cell
+        label(U"Rhine", {1.1f, 0.5f}, 2),
+        label(U"Elbe", {5.05f, 0.5f}, 1),  // beyond the distance, in an adjacent cell
+        label(U"Elbe", {6.5f, 0.5f}, 2),
+        label(U"Oder", {2.9f, 2.9f}, 1),   // beyond the distance, in a diagonal cell
+        label(U"Oder", {3.7f, 3.7f}, 1)
+    };
+
+    gloperate_text::layout::suppressDuplicates(labels, 1.f);
+    EXPECT_EQ((std::vector<std::pair<std::u32string, unsigned int>>{
+        { U"Rhine", 2 }, { U"Elbe", 1 }, { U"Elbe", 2 }, { U"Oder", 1 }, { U"Oder", 1 } }), remaining(labels));
+}
+
+TEST_F(LayoutAlgorithm_test, DifferentTextsAreKept)
+{
+    std::vector<gloperate_text::Label> labels = {
+        label(U"Main", {0.f, 0.f}, 1),
+        label(U"Mainz", {0.f, 0.f}, 2),
+        label(U"main", {0.1f, 0.f}, 3),
+        label(U"Main", {9.f, 9.f}, 0)
+    };
+
+    gloperate_text::layout::suppressDuplicates(labels, 1.f);
+    EXPECT_EQ((std::vector<std::pair<std::u32string, unsigned int>>{
+        { U"Main", 1 }, { U"Mainz", 2 }, { U"main", 3 }, { U"Main", 0 } }), remaining(labels));
+}
+
+TEST_F(LayoutAlgorithm_test, ForceDirectedReducesOverlap)
+{
+    // without iterations, labels stay in the upper right position
+    auto initial = crowdedLabels();
+    std::vector<gloperate_text::LeaderLine> leaderLines;
+    gloperate_text::layout::forceDirected(initial, leaderLines, {0.2f, 0.2f}, 0);
+    EXPECT_TRUE(leaderLines.empty());
+
+    auto placed = crowdedLabels();
+    gloperate_text::layout::forceDirected(placed, leaderLines);
+
+    const auto before = overlapArea(initial);
+    ASSERT_GT(before, 0.f);
+    EXPECT_LT(overlapArea(placed), before * 0.1f);
+    for (const auto & label : placed)
+        EXPECT_TRUE(label.placement.display);
+}
+
+TEST_F(LayoutAlgorithm_test, ForceDirectedLeaderLines)
+{
+    auto initial = crowdedLabels();
+    std::vector<gloperate_text::LeaderLine> leaderLines;
+    gloperate_text::layout::forceDirected(initial, leaderLines, {0.2f, 0.2f}, 0);
+
+    auto placed = crowdedLabels();
+    gloperate_text::layout::forceDirected(placed, leaderLines);
+    ASSERT_FALSE(leaderLines.empty());
+
+    // the isolated label is not moved and needs no leader line
+    EXPECT_EQ(initial.back().placement.offset, placed.back().placement.offset);
+
+    for (size_t i = 0; i < placed.size(); ++i)
+    {
+        const auto & point = placed[i].pointLocation;
+        const auto leaderLine = std::find_if(leaderLines.begin(), leaderLines.end(),
+            [&](const gloperate_text::LeaderLine & line) { return line.start == point; });
+        if (leaderLine == leaderLines.end())
+            continue;
+
+        // leader lines connect displaced labels with their point location
+        const auto displacement = placed[i].placement.offset - initial[i].placement.offset;
+        EXPECT_GT(glm::length(displacement), 0.f);
+
+        const auto lowerLeft = origin(placed[i]);
+        const auto upperRight = lowerLeft + gloperate_text::Typesetter::extent(placed[i].sequence);
+        EXPECT_EQ(glm::clamp(point, lowerLeft, upperRight), leaderLine->end);
+        EXPECT_TRUE(point.x < lowerLeft.x || point.y < lowerLeft.y || point.x > upperRight.x || point.y > upperRight.y);
+    }
+}
+
+TEST_F(LayoutAlgorithm_test, ForceDirectedIsDeterministic)
+{
+    auto first = crowdedLabels();
+    auto second = crowdedLabels();
+    std::vector<gloperate_text::LeaderLine> firstLines;
+    std::vector<gloperate_text::LeaderLine> secondLines;
+    gloperate_text::layout::forceDirected(first, firstLines);
+    gloperate_text::layout::forceDirected(second, secondLines);
+
+    ASSERT_EQ(first.size(), second.size());
+    for (size_t i = 0; i < first.size(); ++i)
+        EXPECT_EQ(first[i].placement.offset, second[i].placement.offset);
+
+    ASSERT_EQ(firstLines.size(), secondLines.size());
+    for (size_t i = 0; i < firstLines.size(); ++i)
+    {
+        EXPECT_EQ(firstLines[i].start, secondLines[i].start);
+        EXPECT_EQ(firstLines[i].end, secondLines[i].end);
+    }
+}
+
+TEST_F(LayoutAlgorithm_test, WrapShapeExtents)
+{
+    // the label's own shape is wrapped as well, at a font size other than the font face's
+    for (const auto wordWrap : { false, true })
+    {
+        auto label = typesetLabel(U"Frankfurt am Main Hauptbahnhof", {0.f, 0.f}, 1);
+        label.sequence.setFontSize(12.f);
+        label.sequence.setWordWrap(wordWrap);
+        label.sequence.setLineWidth(70.f);
+
+        const std::vector<float> lineWidths { 30.f, 60.f, 500.f };
+        const auto extents = gloperate_text::Typesetter::extents(label.sequence, { -1.f, 30.f, 60.f, 500.f });
+        ASSERT_EQ(lineWidths.size() + 1, extents.size());
+
+        const auto own = gloperate_text::Typesetter::extent(label.sequence);
+        EXPECT_FLOAT_EQ(own.x, extents.front().x);
+        EXPECT_FLOAT_EQ(own.y, extents.front().y);
+
+        for (size_t i = 0; i < lineWidths.size(); ++i)
+        {
+            auto wrapped = label.sequence;
+            wrapped.setWordWrap(true);
+            wrapped.setLineWidth(lineWidths[i]);
+
+            const auto extent = gloperate_text::Typesetter::extent(wrapped);
+            EXPECT_FLOAT_EQ(extent.x, extents[i + 1].x);
+            EXPECT_FLOAT_EQ(extent.y, extents[i + 1].y);
+        }
+
+        // the narrowest shape has the most lines
+        EXPECT_GT(extents[1].y, extents[3].y);
+        EXPECT_LE(extents[1].x, 30.f);
+    }
+}
+
+TEST_F(LayoutAlgorithm_test, WrapShapeUnderCongestion)
+{
+    // at the face's font size, "aaaa bbbb cccc" is 112 wide, 88 wrapped at 100 and 48 wrapped at 50
+    auto label = typesetLabel(U"aaaa bbbb cccc", {0.f, 0.f}, 5);
+    label.lineWidths = { 100.f, 50.f };
+
+    std::vector<gloperate_text::Label> alone { label };
+    gloperate_text::layout::greedy(alone, gloperate_text::layout::standard, {0.f, 0.f});
+    EXPECT_TRUE(alone.front().placement.display);
+    EXPECT_FLOAT_EQ(0.f, alone.front().placement.lineWidth);
+
+    // blockers to the left and right leave room for the narrowest shape only
+    auto right = typesetLabel(U"right", {60.f, -200.f}, 9);
+    right.candidates = { { {60.f, -200.f}, {200.f, 400.f}, gloperate_text::RelativeLabelPosition::UpperRight } };
+    auto left = typesetLabel(U"left", {-260.f, -200.f}, 9);
+    left.candidates = { { {-260.f, -200.f}, {200.f, 400.f}, gloperate_text::RelativeLabelPosition::UpperRight } };
+
+    std::vector<gloperate_text::Label> congested { right, left, label };
+    gloperate_text::layout::greedy(congested, gloperate_text::layout::standard, {0.f, 0.f});
+    ASSERT_TRUE(congested[0].placement.display);
+    ASSERT_TRUE(congested[1].placement.display);
+    EXPECT_TRUE(congested[2].placement.display);
+    EXPECT_FLOAT_EQ(50.f, congested[2].placement.lineWidth);
+
+    const auto placed = gloperate_text::applyPlacement(congested[2]);
+    EXPECT_FLOAT_EQ(48.f, gloperate_text::Typesetter::extent(placed).x);
+}
@@ -0,0 +1,53 @@
+
+#include <gmock/gmock.h>
+
+#include <cmath>
+
+
+#include <openll/layout/OrientedLabelArea.h>
+
+class OrientedLabelArea_test: public testing::Test
+{
+public:
+};
+
+TEST_F(OrientedLabelArea_test, AxisAlignedMatchesLabelArea)
+{
+    gloperate_text::OrientedLabelArea a {{0.f, 0.f}, {2.f, 0.f}, {0.f, 2.f}, gloperate_text::RelativeLabelPosition::UpperLeft};
+    gloperate_text::OrientedLabelArea b {{1.f, 1.f}, {2.f, 0.f}, {0.f, 2.f}, gloperate_text::RelativeLabelPosition::UpperLeft};
+    EXPECT_FLOAT_EQ(1.f, a.overlapArea(b));
+    EXPECT_FLOAT_EQ(true, a.overlaps(b));
+    EXPECT_FLOAT_EQ(9.f, a.paddedOverlapArea(b, {0.5f, 0.5f}));
+    EXPECT_FLOAT_EQ(true, a.paddedOverlaps(b, {0.5f, 0.5f}));
+    EXPECT_FLOAT_EQ(4.f, a.area());
+
+    gloperate_text::OrientedLabelArea e {{0.f, 0.f}, {4.f, 0.f}, {0.f, 2.f}, gloperate_text::RelativeLabelPosition::UpperLeft};
+    gloperate_text::OrientedLabelArea f {{0.f, 3.f}, {2.f, 0.f}, {0.f, 2.f}, gloperate_text::RelativeLabelPosition::UpperLeft};
+    EXPECT_FLOAT_EQ(0.f, e.overlapArea(f));
+    EXPECT_FLOAT_EQ(false, e.overlaps(f));
+    EXPECT_FLOAT_EQ(2.f, e.paddedOverlapArea(f, {0.0f, 0.5f}));
+    EXPECT_FLOAT_EQ(true, e.paddedOverlaps(f, {0.0f, 0.5f}));
+}
+
+TEST_F(OrientedLabelArea_test, Rotated)
+{
+    // two thin diagonal labels with overlapping bounding boxes but disjoint footprints
+    gloperate_text::OrientedLabelArea a {{0.f, 0.f}, {4.f, 4.f}, {-0.5f, 0.5f}, gloperate_text::RelativeLabelPosition::UpperRight};
+    gloperate_text::OrientedLabelArea b {{2.f, 0.f}, {4.f, 4.f}, {-0.5f, 0.5f}, gloperate_text::RelativeLabelPosition::UpperRight};
+    EXPECT_EQ(true, a.boundingBox().overlaps(b.boundingBox()));
+    EXPECT_EQ(false, a.overlaps(b));
+    EXPECT_FLOAT_EQ(0.f, a.overlapArea(b));
+    EXPECT_FLOAT_EQ(4.f, a.area());
+
+    // a square rotated by 45 degrees centered on an axis-aligned square of the same size
+    gloperate_text::OrientedLabelArea c {{0.f, 0.f}, {2.f, 0.f}, {0.f, 2.f}, gloperate_text::RelativeLabelPosition::UpperRight};
+    const auto r = std::sqrt(2.f);
+    gloperate_text::OrientedLabelArea d {{1.f, 1.f - r}, {r, r}, {-r, r}, gloperate_text::RelativeLabelPosition::UpperRight};
+    EXPECT_EQ(true, c.overlaps(d));
+    EXPECT_NEAR(8.f * (r - 1.f), c.overlapArea(d), 1e-5f);
+    EXPECT_NEAR(c.overlapArea(d), d.overlapArea(c), 1e-5f);
+
+    gloperate_text::OrientedLabelArea hidden {{1.f, 1.f - r}, {r, r}, {-r, r}, gloperate_text::RelativeLabelPosition::Hidden};
+    EXPECT_EQ(false, c.overlaps(hidden));
+    EXPECT_FLOAT_EQ(0.f, c.overlapArea(hidden));
+}
@@ -0,0 +1,172 @@
+
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <openll/ArcLengthTable.h>
+#include <openll/FontFace.h>
+#include <openll/Glyph.h>
+#include <openll/GlyphSequence.h>
+#include <openll/LineAnchor.h>
+#include <openll/layout/LabelArea.h>
+#include <openll/layout/OrientedLabelArea.h>
+#include <openll/layout/PolylineLabel.h>
+
+class PolylineLabel_test: public testing::Test
+{
+public:
+    PolylineLabel_test()
+    {
+        // lowercase letters with an advance of 10, so that glyph centers are easy to follow
+        m_fontFace.setAscent(16.f);
+        m_fontFace.setDescent(-4.f);
+        m_fontFace.setLineHeight(24.f);
+        m_fontFace.setBase(18.f);
+
+        for (auto c = 97u; c < 123u; ++c)
+        {
+            gloperate_text::Glyph glyph;
+            glyph.setIndex(c);
+            glyph.setAdvance(10.f);
+            glyph.setSubTextureOrigin({0.f, 0.f});
+            glyph.setSubTextureExtent({1.f / 32.f, 1.f / 16.f});
+            glyph.setExtent({8.f, 12.f});
+            glyph.setBearing({1.f, 14.f});
+            m_fontFace.addGlyph(glyph);
+        }
+    }
+
+    gloperate_text::GlyphSequence sequence(const std::u32string & text)
+    {
+        gloperate_text::GlyphSequence sequence;
+        sequence.setString(text);
+        sequence.setFontFace(&m_fontFace);
+        sequence.setFontSize(m_fontFace.size());
+        sequence.setLineAnchor(gloperate_text::LineAnchor::Baseline);
+        return sequence;
+    }
+
+    // where the transform puts the glyph's center on the baseline (in font face space)
+    static glm::vec2 glyphCenter(const glm::mat4 & transform, float center)
+    {
+        return glm::vec2(transform * glm::vec4(center, 0.f, 0.f, 1.f));
+    }
+
+protected:
+    gloperate_text::FontFace m_fontFace;
+};
+
+TEST_F(PolylineLabel_test, GlyphsFollowPath)
+{
+    // an L-shaped path, turning upwards after the second glyph
+    const auto path = gloperate_text::ArcLengthTable({{0.f, 0.f}, {20.f, 0.f}, {20.f, 60.f}});
+    const auto label = gloperate_text::layout::polylineLabel(sequence(U"abcdef"), path, 0.f);
+    ASSERT_EQ(6u, label.glyphTransforms.size());
+    ASSERT_EQ(6u, label.glyphAreas.size());
+
+    const std::vector<glm::vec2> positions { {5.f, 0.f}, {15.f, 0.f}, {20.f, 5.f}, {20.f, 15.f}, {20.f, 25.f}, {20.f, 35.f} };
+    const std::vector<glm::vec2> tangents { {1.f, 0.f}, {1.f, 0.f}, {0.f, 1.f}, {0.f, 1.f}, {0.f, 1.f}, {0.f, 1.f} };
+    for (size_t i = 0; i < positions.size(); ++i)
+    {
+        const auto & transform = label.glyphTransforms[i];
+        const auto position = glyphCenter(transform, 5.f + 10.f * static_cast<float>(i));
+        EXPECT_NEAR(positions[i].x, position.x, 1e-4f);
+        EXPECT_NEAR(positions[i].y, position.y, 1e-4f);
+
+        // the glyph's baseline is aligned with the path's tangent
+        EXPECT_NEAR(tangents[i].x, transform[0].x, 1e-6f);
+        EXPECT_NEAR(tangents[i].y, transform[0].y, 1e-6f);
+        EXPECT_NEAR(-tangents[i].y, transform[1].x, 1e-6f);
+        EXPECT_NEAR(tangents[i].x, transform[1].y, 1e-6f);
+    }
+
+    EXPECT_FLOAT_EQ(0.f, label.start);
+    EXPECT_NEAR(std::acos(0.f), label.curvature, 1e-5f);
+
+    // the bounds span the glyphs from the descent to the ascent
+    EXPECT_NEAR(0.f, label.bounds.origin.x, 1e-4f);
+    EXPECT_NEAR(-4.f, label.bounds.origin.y, 1e-4f);
+    EXPECT_NEAR(24.f, label.bounds.origin.x + label.bounds.extent.x, 1e-4f);
+    EXPECT_NEAR(40.f, label.bounds.origin.y + label.bounds.extent.y, 1e-4f);
+}
+
+TEST_F(PolylineLabel_test, LeftwardPathIsReversed)
+{
+    const auto path = gloperate_text::ArcLengthTable({{100.f, 0.f}, {0.f, 0.f}});
+    const auto label = gloperate_text::layout::polylineLabel(sequence(U"ab"), path, 0.f);
+    ASSERT_EQ(2u, label.glyphTransforms.size());
+
+    // the label covers the path's first 20 units, read from left to right
+    const auto a = glyphCenter(label.glyphTransforms[0], 5.f);
+    const auto b = glyphCenter(label.glyphTransforms[1], 15.f);
+    EXPECT_NEAR(85.f, a.x, 1e-4f);
+    EXPECT_NEAR(95.f, b.x, 1e-4f);
+    EXPECT_NEAR(0.f, a.y, 1e-4f);
+    EXPECT_NEAR(0.f, b.y, 1e-4f);
+
+    // upright: baselines point right and glyphs point up
+    for (const auto & transform : label.glyphTransforms)
+    {
+        EXPECT_NEAR(1.f, transform[0].x, 1e-6f);
+        EXPECT_NEAR(1.f, transform[1].y, 1e-6f);
+    }
+    EXPECT_NEAR(-4.f, label.bounds.origin.y, 1e-4f);
+    EXPECT_NEAR(16.f, label.bounds.origin.y + label.bounds.extent.y, 1e-4f);
+}
+
+TEST_F(PolylineLabel_test, Collision)
+{
+    const auto path = gloperate_text::ArcLengthTable({{0.f, 0.f}, {20.f, 0.f}, {20.f, 60.f}});
+    const auto label = gloperate_text::layout::polylineLabel(sequence(U"abcdef"), path, 0.f);
+
+    const auto area = [](const glm::vec2 & origin, const glm::vec2 & extent) {
+        return gloperate_text::OrientedLabelArea{origin, {extent.x, 0.f}, {0.f, extent.y},
+            gloperate_text::RelativeLabelPosition::UpperRight}; };
+
+    EXPECT_TRUE(label.overlaps(area({12.f, -2.f}, {4.f, 4.f})));
+    EXPECT_TRUE(label.overlaps(area({22.f, 30.f}, {4.f, 4.f})));
+    EXPECT_FALSE(label.overlaps(area({40.f, 50.f}, {4.f, 4.f})));
+
+    // within the bounds, but in the corner between the glyphs
+    const auto corner = area({0.f, 30.f}, {2.f, 2.f});
+    EXPECT_TRUE(label.bounds.overlaps(gloperate_text::LabelArea{corner.origin, {2.f, 2.f},
+        gloperate_text::RelativeLabelPosition::UpperRight}));
+    EXPECT_FALSE(label.overlaps(corner));
+    EXPECT_TRUE(label.paddedOverlaps(corner, {1.f, 1.f}));
+
+    // labels along crossing and parallel paths
+    const auto crossing = gloperate_text::layout::polylineLabel(sequence(U"abc"),
+        gloperate_text::ArcLengthTable({{10.f, -20.f}, {10.f, 40.f}}), 0.f);
+    const auto parallel = gloperate_text::layout::polylineLabel(sequence(U"abc"),
+        gloperate_text::ArcLengthTable({{0.f, -40.f}, {60.f, -40.f}}), 0.f);
+    EXPECT_TRUE(label.overlaps(crossing));
+    EXPECT_TRUE(crossing.overlaps(label));
+    EXPECT_FALSE(label.overlaps(parallel));
+    EXPECT_FALSE(parallel.overlaps(label));
+}
+
+TEST_F(PolylineLabel_test, LabelLongerThanPathIsRejected)
+{
+    const auto text = sequence(U"abcd"); // 40 units long
+
+    EXPECT_TRUE(gloperate_text::layout::polylineLabels(text,
+        gloperate_text::ArcLengthTable({{0.f, 0.f}, {30.f, 0.f}}), 5.f).empty());
+    EXPECT_TRUE(gloperate_text::layout::polylineLabels(text,
+        gloperate_text::ArcLengthTable({{0.f, 0.f}, {20.f, 0.f}, {20.f, 19.f}}), 5.f).empty());
+
+    const auto exact = gloperate_text::layout::polylineLabels(text,
+        gloperate_text::ArcLengthTable({{0.f, 0.f}, {40.f, 0.f}}), 5.f);
+    ASSERT_EQ(1u, exact.size());
+    EXPECT_FLOAT_EQ(0.f, exact.front().start);
+
+    const auto longer = gloperate_text::layout::polylineLabels(text,
+        gloperate_text::ArcLengthTable({{0.f, 0.f}, {50.f, 0.f}}), 5.f);
+    ASSERT_EQ(3u, longer.size());
+    EXPECT_FLOAT_EQ(10.f, longer.back().start);
+}
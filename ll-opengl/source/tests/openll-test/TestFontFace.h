@@ -0,0 +1,67 @@
+
+#pragma once
+
+
+#include <glm/vec4.hpp>
+
+#include <openll/FontFace.h>
+#include <openll/Glyph.h>
+
+
+// printable ascii with varying advances, where the space is not depictable
+inline void setupTestFontFace(gloperate_text::FontFace & fontFace)
+{
+    fontFace.setAscent(16.f);
+    fontFace.setDescent(-4.f);
+    fontFace.setLineHeight(24.f);
+    fontFace.setBase(18.f);
+
+    for (auto c = 32u; c < 127u; ++c)
+    {
+        gloperate_text::Glyph glyph;
+        glyph.setIndex(c);
+        glyph.setAdvance(4.f + static_cast<float>(c * 7 % 11));
+        if (c > 32u)
+        {
+            glyph.setSubTextureOrigin({0.f, 0.f});
+            glyph.setSubTextureExtent({1.f / 32.f, 1.f / 16.f});
+            glyph.setExtent({3.f + static_cast<float>(c % 5), 12.f});
+            glyph.setBearing({0.5f, 14.f});
+        }
+        fontFace.addGlyph(glyph);
+    }
+}
+
+// printable ascii and a non-ascii glyph (U+00E9) of the given advance, where the space is not
+// depictable, optionally with a line feed of that advance; a font face of fixed pitch
+inline void setupFixedPitchTestFontFace(gloperate_text::FontFace & fontFace, float pitch, bool lineFeed)
+{
+    fontFace.setAscent(16.f);
+    fontFace.setDescent(-4.f);
+    fontFace.setLineHeight(24.f);
+    fontFace.setGlyphTexturePadding(glm::vec4(1.f, 1.f, 1.f, 1.f));
+
+    for (auto c = 32u; c < 128u; ++c)
+    {
+        gloperate_text::Glyph glyph;
+        glyph.setIndex(c < 127u ? c : 0xE9u);
+        glyph.setAdvance(pitch);
+        if (c > 32u)
+        {
+            glyph.setSubTextureOrigin({static_cast<float>(c % 16) / 16.f, 0.f});
+            glyph.setSubTextureExtent({1.f / 32.f, 1.f / 16.f});
+            glyph.setExtent({6.f, 12.f});
+            glyph.setBearing({0.5f, 14.f});
+        }
+        fontFace.addGlyph(glyph);
+    }
+
+    if (lineFeed)
+    {
+        gloperate_text::Glyph glyph;
+        glyph.setIndex(0x0Au);
+        glyph.setAdvance(pitch);
+        fontFace.addGlyph(glyph);
+    }
+    fontFace.detectFixedAdvance();
+}
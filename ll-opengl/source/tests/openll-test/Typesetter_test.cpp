@@ -0,0 +1,859 @@
+
+#include <gmock/gmock.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
+#include <glm/mat4x4.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <openll/Alignment.h>
+#include <openll/ArcLengthTable.h>
+#include <openll/FontFace.h>
+#include <openll/Glyph.h>
+#include <openll/GlyphSequence.h>
+#include <openll/LineAnchor.h>
+#include <openll/LineIndex.h>
+#include <openll/LineMetrics.h>
+#include <openll/Typesetter.h>
+
+#include "TestFontFace.h"
+
+class Typesetter_test: public testing::Test
+{
+public:
+    Typesetter_test()
+    {
+        // with glyph texture padding and kerning
+        setupTestFontFace(m_fontFace);
+        m_fontFace.setGlyphTexturePadding(glm::vec4(1.f, 1.f, 1.f, 1.f));
+
+        for (auto c = 33u; c < 127u; c += 3)
+        {
+            for (auto d = 34u; d < 127u; d += 5)
+                m_fontFace.setKerning(c, d, -0.5f * static_cast<float>((c + d) % 4));
+        }
+    }
+
+    // the former line breaking: glyphs and kerning are looked up per step, word widths are
+    // scanned forward from the current glyph; returns the pen of each glyph and line widths
+    std::vector<glm::vec2> referencePens(const gloperate_text::GlyphSequence & sequence, std::vector<float> & lineWidths)
+    {
+        const auto delimiters = std::u32string(U"\n ,.-/()[]<>");
+        const auto & string = sequence.string();
+
+        std::vector<glm::vec2> pens;
+        auto pen = glm::vec2(0.f);
+        size_t safeForward = 0;
+
+        const auto endLine = [&](size_t index)
+        {
+            while (index > 0 && !m_fontFace.glyph(string[index]).depictable())
+                pen.x -= m_fontFace.glyph(string[index--]).advance();
+            lineWidths.push_back(pen.x);
+        };
+
+        for (size_t i = 0; i < string.size(); ++i)
+        {
+            const auto & glyph = m_fontFace.glyph(string[i]);
+            const auto kerning = i > 0 ? m_fontFace.kerning(string[i - 1], string[i]) : 0.f;
+            const auto lineWidth = sequence.lineWidth();
+
+            auto feedLine = string[i] == gloperate_text::Typesetter::lineFeed();
+            if (!feedLine && sequence.wordWrap())
+            {
+                feedLine = glyph.depictable() && pen.x + glyph.advance() + kerning > lineWidth
+                    && (glyph.advance() <= lineWidth || pen.x > 0.f);
+
+                if (!feedLine && i >= safeForward)
+                {
+                    auto width = 0.f;
+                    for (safeForward = i; safeForward < string.size() && delimiters.find(string[safeForward]) == std::u32string::npos; ++safeForward)
+                    {
+                        if (safeForward > 0)
+                            width += m_fontFace.kerning(string[safeForward - 1], string[safeForward]);
+                        width += m_fontFace.glyph(string[safeForward]).advance();
+                    }
+                    feedLine = width <= lineWidth && pen.x + width > lineWidth;
+                }
+            }
+
+            if (feedLine)
+            {
+                endLine(i - 1);
+                pen.x = 0.f;
+                pen.y -= m_fontFace.lineHeight();
+            }
+            else
+                pen.x += kerning;
+
+            pens.push_back(pen);
+            pen.x += glyph.advance();
+        }
+
+        if (!string.empty())
+            endLine(string.size() - 1);
+        return pens;
+    }
+
+protected:
+    gloperate_text::FontFace m_fontFace;
+};
+
+TEST_F(Typesetter_test, LineBreakingMatchesReference)
+{
+    const auto string = std::u32string(
+        U"The quick brown fox (jumps) over the lazy dog.\nPack my box with five dozen liquor-jugs,  "
+        U"Sphinx/of/black/quartz, judge my vow!   Incomprehensibilities\n\nx [y] <z>  ");
+
+    const std::vector<gloperate_text::Alignment> alignments {
+        gloperate_text::Alignment::LeftAligned, gloperate_text::Alignment::Centered,
+        gloperate_text::Alignment::RightAligned };
+    const std::vector<gloperate_text::LineAnchor> lineAnchors {
+        gloperate_text::LineAnchor::Top, gloperate_text::LineAnchor::Ascent, gloperate_text::LineAnchor::Center,
+        gloperate_text::LineAnchor::Baseline, gloperate_text::LineAnchor::Descent, gloperate_text::LineAnchor::Bottom };
+
+    for (const auto wordWrap : { false, true })
+    {
+        for (const auto lineWidth : { 0.f, 9.f, 60.f, 150.f, 1000.f })
+        {
+            gloperate_text::GlyphSequence sequence;
+            sequence.setString(string);
+            sequence.setFontFace(&m_fontFace);
+            sequence.setFontSize(m_fontFace.size());
+            sequence.setWordWrap(wordWrap);
+            sequence.setLineWidth(lineWidth);
+
+            std::vector<float> lineWidths;
+            const auto pens = referencePens(sequence, lineWidths);
+
+            auto width = 0.f;
+            for (const auto & w : lineWidths)
+                width = glm::max(width, w);
+            const auto height = lineWidths.size() * m_fontFace.lineHeight();
+
+            const auto extent = gloperate_text::Typesetter::extent(sequence);
+            EXPECT_FLOAT_EQ(width, extent.x);
+            EXPECT_FLOAT_EQ(height, extent.y);
+
+            if (wordWrap)
+            {
+                const auto extents = gloperate_text::Typesetter::extents(sequence, { lineWidth });
+                EXPECT_FLOAT_EQ(width, extents.front().x);
+                EXPECT_FLOAT_EQ(height, extents.front().y);
+            }
+
+            for (const auto alignment : alignments)
+            {
+                for (const auto lineAnchor : lineAnchors)
+                {
+                    sequence.setAlignment(alignment);
+                    sequence.setLineAnchor(lineAnchor);
+
+                    gloperate_text::GlyphVertexCloud::Vertices vertices(sequence.depictableSize());
+                    gloperate_text::Typesetter::typeset(sequence, vertices.begin());
+
+                    const auto & padding = m_fontFace.glyphTexturePadding();
+                    auto vertex = vertices.cbegin();
+                    for (size_t i = 0; i < string.size(); ++i)
+                    {
+                        const auto & glyph = m_fontFace.glyph(string[i]);
+                        if (!glyph.depictable())
+                            continue;
+
+                        const auto line = static_cast<size_t>(-pens[i].y / m_fontFace.lineHeight() + 0.5f);
+                        auto offset = 0.f;
+                        if (alignment == gloperate_text::Alignment::Centered)
+                            offset = -0.5f * lineWidths[line];
+                        if (alignment == gloperate_text::Alignment::RightAligned)
+                            offset = -lineWidths[line];
+
+                        const auto x = pens[i].x + glyph.bearing().x - padding[3] + offset;
+                        const auto y = pens[i].y + glyph.bearing().y - glyph.extent().y + padding[0]
+                            - gloperate_text::Typesetter::anchorOffset(sequence);
+
+                        EXPECT_FLOAT_EQ(x, vertex->origin.x);
+                        EXPECT_FLOAT_EQ(y, vertex->origin.y);
+                        ++vertex;
+                    }
+                    EXPECT_EQ(vertices.cend(), vertex);
+                }
+            }
+        }
+    }
+}
+
+TEST_F(Typesetter_test, FontSpaceTypesettingMatchesTypeset)
+{
+    gloperate_text::GlyphSequence sequence;
+    sequence.setString(U"Lorem ipsum dolor sit amet,\nconsectetur adipisici elit");
+    sequence.setFontFace(&m_fontFace);
+    sequence.setFontSize(12.f);
+    sequence.setWordWrap(true);
+    sequence.setLineWidth(80.f);
+    sequence.setAlignment(gloperate_text::Alignment::Centered);
+    sequence.setLineAnchor(gloperate_text::LineAnchor::Ascent);
+    sequence.setFontColor(glm::vec4(1.f, 0.5f, 0.25f, 1.f));
+
+    gloperate_text::GlyphVertexCloud::Vertices fontSpace(sequence.depictableSize());
+    gloperate_text::Typesetter::typesetFontSpace(sequence, fontSpace.begin());
+
+    // moving the label only requires the transform to be reapplied
+    for (const auto x : { 0.f, 10.f, -3.5f })
+    {
+        auto transform = glm::mat4();
+        transform[3] = glm::vec4(x, 2.f * x, 0.f, 1.f);
+        sequence.setAdditionalTransform(transform);
+
+        gloperate_text::GlyphVertexCloud::Vertices expected(sequence.depictableSize());
+        gloperate_text::Typesetter::typeset(sequence, expected.begin());
+
+        gloperate_text::GlyphVertexCloud::Vertices vertices(sequence.depictableSize());
+        gloperate_text::Typesetter::transform(sequence, fontSpace.cbegin(), fontSpace.cend(), vertices.begin());
+
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            EXPECT_EQ(expected[i].origin, vertices[i].origin);
+            EXPECT_EQ(expected[i].vtan, vertices[i].vtan);
+            EXPECT_EQ(expected[i].vbitan, vertices[i].vbitan);
+            EXPECT_EQ(expected[i].uvRect, vertices[i].uvRect);
+            EXPECT_EQ(expected[i].fontColor, vertices[i].fontColor);
+        }
+    }
+}
+
+TEST_F(Typesetter_test, SpanTypesettingMatchesTypeset)
+{
+    gloperate_text::GlyphSequence sequence;
+    sequence.setString(U"Lorem ipsum dolor sit amet,\nconsectetur adipisici elit");
+    sequence.setFontFace(&m_fontFace);
+    sequence.setFontSize(12.f);
+    sequence.setWordWrap(true);
+    sequence.setLineWidth(80.f);
+    sequence.setAlignment(gloperate_text::Alignment::RightAligned);
+
+    gloperate_text::GlyphVertexCloud::Vertices expected(sequence.depictableSize());
+    const auto expectedExtent = gloperate_text::Typesetter::typeset(sequence, expected.begin());
+
+    // caller-provided storage, with a trailing vertex that must remain untouched
+    gloperate_text::GlyphVertexCloud::Vertex sentinel = { };
+    sentinel.superSampling = 42u;
+    std::vector<gloperate_text::GlyphVertexCloud::Vertex> storage(expected.size() + 1, sentinel);
+
+    const auto extent = gloperate_text::Typesetter::typeset(sequence, storage.data());
+    EXPECT_EQ(expectedExtent, extent);
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(expected[i].origin, storage[i].origin);
+        EXPECT_EQ(expected[i].vtan, storage[i].vtan);
+        EXPECT_EQ(expected[i].vbitan, storage[i].vbitan);
+        EXPECT_EQ(expected[i].uvRect, storage[i].uvRect);
+    }
+    EXPECT_EQ(42u, storage.back().superSampling);
+}
+
+TEST_F(Typesetter_test, LineRangeTypesettingMatchesTypeset)
+{
+    std::u32string string;
+    for (auto i = 0; i < 40; ++i)
+        string += U"line " + std::u32string(static_cast<size_t>(i % 7), U'x') + U" (wrapped) words,\n";
+
+    // varying advances, and fixed pitch (of a pitch whose multiples are rounded) with and
+    // without a line feed glyph
+    gloperate_text::FontFace fixedPitch;
+    setupFixedPitchTestFontFace(fixedPitch, 7.3f, false);
+    gloperate_text::FontFace fixedPitchLineFeed;
+    setupFixedPitchTestFontFace(fixedPitchLineFeed, 7.3f, true);
+
+    for (const auto fontFace : { &m_fontFace, &fixedPitch, &fixedPitchLineFeed })
+    {
+        gloperate_text::GlyphSequence sequence;
+        sequence.setString(string);
+        sequence.setFontFace(fontFace);
+        sequence.setFontSize(12.f);
+        sequence.setWordWrap(true);
+        sequence.setLineWidth(40.f);
+        sequence.setAlignment(gloperate_text::Alignment::Centered);
+        sequence.setLineAnchor(gloperate_text::LineAnchor::Top);
+        EXPECT_EQ(fontFace == &m_fontFace ? 0.f : 7.3f, sequence.fixedPitch());
+
+        gloperate_text::GlyphVertexCloud::Vertices expected(sequence.depictableSize());
+        gloperate_text::Typesetter::typeset(sequence, expected.begin());
+
+        const auto index = gloperate_text::LineIndex(sequence);
+        EXPECT_EQ(index.vertexCount(0, index.size()), expected.size());
+        EXPECT_EQ(index.extent().y, index.size() * fontFace->lineHeight());
+
+        // a window of about two lines scrolled through the text, whose lines span
+        // [base - extent.y, base] in font face space
+        for (auto top = 10.f; top > fontFace->base() - index.extent().y; top -= 17.f)
+        {
+            const auto lines = index.linesWithin(top, top - 2.f * fontFace->lineHeight());
+            ASSERT_LT(lines.first, lines.second);
+            EXPECT_LE(lines.second - lines.first, 3u);
+
+            gloperate_text::GlyphVertexCloud::Vertices vertices(index.vertexCount(lines.first, lines.second));
+            gloperate_text::Typesetter::typeset(sequence, index.lines(), lines.first, lines.second, vertices.data());
+
+            const auto offset = index.lines()[lines.first].vertexBegin;
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                EXPECT_EQ(expected[offset + i].origin, vertices[i].origin);
+                EXPECT_EQ(expected[offset + i].vtan, vertices[i].vtan);
+                EXPECT_EQ(expected[offset + i].uvRect, vertices[i].uvRect);
+            }
+        }
+    }
+}
+
+TEST_F(Typesetter_test, RetypesetMatchesTypeset)
+{
+    const auto alphabet = std::u32string(U"abcdefghijklmnopqrstuvwxyz      ,.-()\n");
+    std::mt19937 random(7);
+
+    const auto randomString = [&](size_t size)
+    {
+        auto string = std::u32string();
+        for (size_t i = 0; i < size; ++i)
+            string += alphabet[random() % alphabet.size()];
+        return string;
+    };
+
+    // varying advances, and fixed pitch (of a pitch whose multiples are rounded) with and
+    // without a line feed glyph
+    gloperate_text::FontFace fixedPitch;
+    setupFixedPitchTestFontFace(fixedPitch, 7.3f, false);
+    gloperate_text::FontFace fixedPitchLineFeed;
+    setupFixedPitchTestFontFace(fixedPitchLineFeed, 7.3f, true);
+    gloperate_text::FontFace * fontFaces[] = { &m_fontFace, &fixedPitch, &fixedPitchLineFeed };
+
+    for (auto run = 0; run < 72; ++run)
+    {
+        const auto fontFace = fontFaces[run / 24];
+
+        // as for typeset, strings must not begin with a line feed
+        const auto trimLineFeeds = [](gloperate_text::GlyphSequence & sequence)
+        {
+            while (!sequence.string().empty() && sequence.string()[0] == gloperate_text::Typesetter::lineFeed())
+                sequence.erase(0, 1);
+        };
+
+        const auto lineWidth = static_cast<float>(random() % 90);
+
+        gloperate_text::GlyphSequence sequence;
+        sequence.setString(randomString(random() % 300));
+        sequence.setFontFace(fontFace);
+        sequence.setWordWrap(run % 4 != 0);
+        sequence.setLineWidth(lineWidth);
+        trimLineFeeds(sequence);
+        sequence.setAlignment(static_cast<gloperate_text::Alignment>(run % 3));
+        sequence.setLineAnchor(gloperate_text::LineAnchor::Center);
+
+        std::vector<gloperate_text::LineMetrics> lines;
+        gloperate_text::Typesetter::measureLines(sequence, lines);
+        gloperate_text::GlyphVertexCloud::Vertices vertices(sequence.depictableSize());
+        gloperate_text::Typesetter::typeset(sequence, vertices.begin());
+        sequence.resetEdit();
+
+        for (auto step = 0; step < 40; ++step)
+        {
+            // one or more edits, merged into a single one
+            for (auto edits = 1 + random() % 3; edits > 0; --edits)
+            {
+                const auto position = random() % (sequence.size() + 1);
+                switch (random() % 3)
+                {
+                case 0:
+                    sequence.insert(position, randomString(1 + random() % 12));
+                    break;
+                case 1:
+                    sequence.erase(position, 1 + random() % 12);
+                    break;
+                default:
+                    sequence.append(randomString(1 + random() % 12));
+                }
+            }
+            trimLineFeeds(sequence);
+
+            const auto extent = gloperate_text::Typesetter::retypeset(sequence, sequence.edit(), lines, vertices);
+            sequence.resetEdit();
+
+            // typeset from scratch
+            gloperate_text::GlyphSequence expected;
+            expected.setString(sequence.string());
+            expected.setFontFace(fontFace);
+            expected.setWordWrap(sequence.wordWrap());
+            expected.setLineWidth(lineWidth);
+            expected.setAlignment(sequence.alignment());
+            expected.setLineAnchor(sequence.lineAnchor());
+
+            ASSERT_EQ(expected.depictableSize(), sequence.depictableSize());
+            for (size_t i = 0; i < expected.size(); ++i)
+            {
+                ASSERT_EQ(expected.glyphRun()[i].glyph, sequence.glyphRun()[i].glyph);
+                ASSERT_EQ(expected.glyphRun()[i].kerning, sequence.glyphRun()[i].kerning);
+            }
+
+            std::vector<gloperate_text::LineMetrics> expectedLines;
+            gloperate_text::Typesetter::measureLines(expected, expectedLines);
+            gloperate_text::GlyphVertexCloud::Vertices expectedVertices(expected.depictableSize());
+            const auto expectedExtent = gloperate_text::Typesetter::typeset(expected, expectedVertices.begin());
+
+            EXPECT_EQ(expectedExtent, extent);
+
+            ASSERT_EQ(expectedLines.size(), lines.size());
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                EXPECT_EQ(expectedLines[i].begin, lines[i].begin);
+                EXPECT_EQ(expectedLines[i].end, lines[i].end);
+                EXPECT_EQ(expectedLines[i].vertexBegin, lines[i].vertexBegin);
+                EXPECT_EQ(expectedLines[i].vertexEnd, lines[i].vertexEnd);
+                EXPECT_EQ(expectedLines[i].baseline, lines[i].baseline);
+                EXPECT_EQ(expectedLines[i].width, lines[i].width);
+                EXPECT_EQ(expectedLines[i].offset, lines[i].offset);
+            }
+
+            ASSERT_EQ(expectedVertices.size(), vertices.size());
+            for (size_t i = 0; i < vertices.size(); ++i)
+            {
+                EXPECT_EQ(expectedVertices[i].origin, vertices[i].origin);
+                EXPECT_EQ(expectedVertices[i].vtan, vertices[i].vtan);
+                EXPECT_EQ(expectedVertices[i].vbitan, vertices[i].vbitan);
+                EXPECT_EQ(expectedVertices[i].uvRect, vertices[i].uvRect);
+            }
+        }
+    }
+}
+
+TEST_F(Typesetter_test, RecordedLinesMatchMeasuredLines)
+{
+    gloperate_text::GlyphSequence sequence;
+    sequence.setString(U"Lorem ipsum dolor sit amet,\nconsectetur adipisici elit, sed eiusmod tempor");
+    sequence.setFontFace(&m_fontFace);
+    sequence.setFontSize(12.f);
+    sequence.setWordWrap(true);
+    sequence.setLineWidth(60.f);
+    sequence.setAlignment(gloperate_text::Alignment::Centered);
+    sequence.setLineAnchor(gloperate_text::LineAnchor::Center);
+
+    std::vector<gloperate_text::LineMetrics> expectedLines;
+    gloperate_text::Typesetter::measureLines(sequence, expectedLines);
+    gloperate_text::GlyphVertexCloud::Vertices expected(sequence.depictableSize());
+    const auto expectedExtent = gloperate_text::Typesetter::typeset(sequence, expected.begin());
+
+    // recorded lines replace previous ones
+    std::vector<gloperate_text::LineMetrics> lines(2);
+    gloperate_text::GlyphVertexCloud::Vertices vertices(sequence.depictableSize());
+    const auto extent = gloperate_text::Typesetter::typeset(sequence, vertices.begin(), lines);
+    EXPECT_EQ(expectedExtent, extent);
+
+    ASSERT_LT(1u, expectedLines.size());
+    ASSERT_EQ(expectedLines.size(), lines.size());
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        EXPECT_EQ(expectedLines[i].begin, lines[i].begin);
+        EXPECT_EQ(expectedLines[i].end, lines[i].end);
+        EXPECT_EQ(expectedLines[i].vertexBegin, lines[i].vertexBegin);
+        EXPECT_EQ(expectedLines[i].vertexEnd, lines[i].vertexEnd);
+        EXPECT_EQ(expectedLines[i].baseline, lines[i].baseline);
+        EXPECT_EQ(expectedLines[i].width, lines[i].width);
+        EXPECT_EQ(expectedLines[i].offset, lines[i].offset);
+        EXPECT_EQ(expectedLines[i].wordEnd, lines[i].wordEnd);
+    }
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(expected[i].origin, vertices[i].origin);
+        EXPECT_EQ(expected[i].uvRect, vertices[i].uvRect);
+    }
+}
+
+TEST_F(Typesetter_test, CurvedBaselineTypesetting)
+{
+    gloperate_text::GlyphSequence sequence;
+    sequence.setString(U"Lorem ipsum dolor");
+    sequence.setFontFace(&m_fontFace);
+    sequence.setFontSize(12.f);
+    sequence.setLineAnchor(gloperate_text::LineAnchor::Center);
+    sequence.setAdditionalTransform(glm::translate(glm::mat4(1.f), glm::vec3(3.f, 4.f, 0.f)));
+
+    gloperate_text::GlyphVertexCloud::Vertices expected(sequence.depictableSize());
+    gloperate_text::Typesetter::typeset(sequence, expected.begin());
+
+    // along a straight baseline of several segments, as typeset by default
+    const auto straight = gloperate_text::ArcLengthTable({{0.f, 0.f}, {10.f, 0.f}, {25.f, 0.f}, {30.f, 0.f}});
+    gloperate_text::GlyphVertexCloud::Vertices vertices(sequence.depictableSize());
+    gloperate_text::Typesetter::typeset(sequence, straight, 0.f, vertices.begin());
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_NEAR(expected[i].origin.x, vertices[i].origin.x, 1e-4f);
+        EXPECT_NEAR(expected[i].origin.y, vertices[i].origin.y, 1e-4f);
+        EXPECT_NEAR(expected[i].vtan.x, vertices[i].vtan.x, 1e-4f);
+        EXPECT_NEAR(expected[i].vbitan.y, vertices[i].vbitan.y, 1e-4f);
+        EXPECT_EQ(expected[i].uvRect, vertices[i].uvRect);
+    }
+
+    // along a right angle, centered at the corner: glyphs are rotated and their centers are
+    // on the baseline (offset by the line anchor along the normal)
+    sequence.setAlignment(gloperate_text::Alignment::Centered);
+    sequence.setAdditionalTransform(glm::mat4(1.f));
+    const auto corner = gloperate_text::ArcLengthTable({{-100.f, 0.f}, {0.f, 0.f}, {0.f, 100.f}});
+    gloperate_text::Typesetter::typeset(sequence, corner, 100.f, vertices.begin());
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const auto & vertex = vertices[i];
+        const auto center = glm::vec2(vertex.origin.x, vertex.origin.y)
+            + 0.5f * glm::vec2(vertex.vtan.x, vertex.vtan.y);
+        const auto baselineOffset = expected[i].origin.y - 4.f;
+
+        if (vertex.vtan.x > 0.f)
+        {
+            EXPECT_FLOAT_EQ(0.f, vertex.vtan.y);
+            EXPECT_LT(center.x, 0.f);
+            EXPECT_NEAR(baselineOffset, vertex.origin.y, 1e-4f);
+        }
+        else
+        {
+            EXPECT_NEAR(0.f, vertex.vtan.x, 1e-4f);
+            EXPECT_GT(vertex.vtan.y, 0.f);
+            EXPECT_LT(vertex.vbitan.x, 0.f);
+            EXPECT_GT(center.y, 0.f);
+            EXPECT_NEAR(-baselineOffset, vertex.origin.x, 1e-4f);
+        }
+    }
+}
+
+TEST_F(Typesetter_test, FixedPitchMatchesVaryingPitch)
+{
+    std::mt19937 random(7);
+    std::u32string string;
+    for (auto i = 0; i < 2000; ++i)
+        string += random() % 8 == 0 ? U' ' : random() % 64 == 0 ? U'\n' : random() % 64 == 0 ? U'é' : static_cast<char32_t>(33 + random() % 94);
+    string.erase(0, string.find_first_not_of(U'\n'));
+
+    // typeset with transform and lines, and in font face space
+    struct Result
+    {
+        float pitch;
+        glm::vec2 extent;
+        gloperate_text::GlyphVertexCloud::Vertices vertices;
+        gloperate_text::GlyphVertexCloud::Vertices fontSpaceVertices;
+        std::vector<gloperate_text::LineMetrics> lines;
+    };
+
+    // with and without a line feed glyph, which advances the pen as any other glyph
+    for (const auto lineFeed : { false, true })
+    {
+        gloperate_text::FontFace fontFace;
+        setupFixedPitchTestFontFace(fontFace, 7.5f, lineFeed);
+        EXPECT_EQ(7.5f, fontFace.fixedAdvance());
+
+        const auto sequenceFor = [&](gloperate_text::Alignment alignment)
+        {
+            gloperate_text::GlyphSequence sequence;
+            sequence.setString(string);
+            sequence.setFontFace(&fontFace);
+            sequence.setFontSize(12.f);
+            sequence.setWordWrap(true);
+            sequence.setLineWidth(60.f);
+            sequence.setAlignment(alignment);
+            sequence.setLineAnchor(gloperate_text::LineAnchor::Center);
+            sequence.setAdditionalTransform(glm::rotate(glm::translate(glm::mat4(), glm::vec3(10.f, -5.f, 1.f))
+                , 0.3f, glm::vec3(0.f, 0.f, 1.f)));
+            return sequence;
+        };
+
+        const auto typeset = [&](gloperate_text::Alignment alignment)
+        {
+            const auto sequence = sequenceFor(alignment);
+
+            Result result;
+            result.pitch = sequence.fixedPitch();
+            result.vertices.resize(sequence.depictableSize());
+            result.fontSpaceVertices.resize(sequence.depictableSize());
+            result.extent = gloperate_text::Typesetter::typeset(sequence, result.vertices.begin(), result.lines);
+            gloperate_text::Typesetter::typesetFontSpace(sequence, result.fontSpaceVertices.begin());
+            return result;
+        };
+
+        const std::vector<gloperate_text::Alignment> alignments { gloperate_text::Alignment::LeftAligned
+            , gloperate_text::Alignment::Centered, gloperate_text::Alignment::RightAligned };
+
+        std::vector<Result> fixedResults;
+        for (const auto alignment : alignments)
+        {
+            fixedResults.push_back(typeset(alignment));
+            EXPECT_EQ(7.5f, fixedResults.back().pitch);
+        }
+
+        // measuring breaks lines as typesetting does
+        EXPECT_EQ(fixedResults.front().extent, gloperate_text::Typesetter::extent(sequenceFor(alignments.front())));
+
+        // any kerning disables the fixed pitch path
+        fontFace.setKerning('a', 'b', 0.f);
+        EXPECT_EQ(0.f, fontFace.fixedAdvance());
+
+        // column pens equal summed up advances of this pitch, so the results are identical
+        for (size_t a = 0; a < alignments.size(); ++a)
+        {
+            const auto & fixed = fixedResults[a];
+            const auto varying = typeset(alignments[a]);
+            EXPECT_EQ(0.f, varying.pitch);
+            EXPECT_EQ(varying.extent, fixed.extent);
+
+            ASSERT_EQ(varying.lines.size(), fixed.lines.size());
+            EXPECT_LT(1u, fixed.lines.size());
+            for (size_t i = 0; i < varying.lines.size(); ++i)
+            {
+                EXPECT_EQ(varying.lines[i].begin, fixed.lines[i].begin);
+                EXPECT_EQ(varying.lines[i].end, fixed.lines[i].end);
+                EXPECT_EQ(varying.lines[i].vertexBegin, fixed.lines[i].vertexBegin);
+                EXPECT_EQ(varying.lines[i].vertexEnd, fixed.lines[i].vertexEnd);
+                EXPECT_EQ(varying.lines[i].wordEnd, fixed.lines[i].wordEnd);
+                EXPECT_EQ(varying.lines[i].baseline, fixed.lines[i].baseline);
+                EXPECT_EQ(varying.lines[i].width, fixed.lines[i].width);
+                EXPECT_EQ(varying.lines[i].offset, fixed.lines[i].offset);
+            }
+
+            ASSERT_EQ(varying.vertices.size(), fixed.vertices.size());
+            for (size_t i = 0; i < varying.vertices.size(); ++i)
+            {
+                EXPECT_EQ(varying.vertices[i].origin, fixed.vertices[i].origin);
+                EXPECT_EQ(varying.vertices[i].vtan, fixed.vertices[i].vtan);
+                EXPECT_EQ(varying.vertices[i].vbitan, fixed.vertices[i].vbitan);
+                EXPECT_EQ(varying.vertices[i].uvRect, fixed.vertices[i].uvRect);
+                EXPECT_EQ(varying.vertices[i].fontColor, fixed.vertices[i].fontColor);
+                EXPECT_EQ(varying.vertices[i].superSampling, fixed.vertices[i].superSampling);
+
+                EXPECT_EQ(varying.fontSpaceVertices[i].origin, fixed.fontSpaceVertices[i].origin);
+                EXPECT_EQ(varying.fontSpaceVertices[i].vtan, fixed.fontSpaceVertices[i].vtan);
+                EXPECT_EQ(varying.fontSpaceVertices[i].vbitan, fixed.fontSpaceVertices[i].vbitan);
+                EXPECT_EQ(varying.fontSpaceVertices[i].uvRect, fixed.fontSpaceVertices[i].uvRect);
+            }
+        }
+    }
+}
+
+TEST_F(Typesetter_test, BatchExtentsMatchExtent)
+{
+    std::mt19937 random(3);
+    std::vector<std::u32string> strings(300);
+    for (auto & string : strings)
+    {
+        const auto length = random() % 40;
+        for (auto i = 0u; i < length; ++i)
+            string += random() % 6 == 0 ? U' ' : random() % 30 == 0 ? U'\n' : static_cast<char32_t>(33 + random() % 94);
+        string.erase(0, string.find_first_not_of(U'\n'));
+    }
+
+    for (const auto lineWidth : { -1.f, 0.f, 60.f })
+    {
+        std::vector<std::vector<float>> lineWidths;
+        const auto extents = gloperate_text::Typesetter::extents(m_fontFace, 14.f, strings, lineWidth, &lineWidths);
+        ASSERT_EQ(strings.size(), extents.size());
+        ASSERT_EQ(strings.size(), lineWidths.size());
+
+        for (size_t i = 0; i < strings.size(); ++i)
+        {
+            gloperate_text::GlyphSequence sequence;
+            sequence.setString(strings[i]);
+            sequence.setFontFace(&m_fontFace);
+            sequence.setFontSize(14.f);
+            sequence.setWordWrap(lineWidth >= 0.f);
+            sequence.setLineWidth(lineWidth);
+
+            EXPECT_EQ(gloperate_text::Typesetter::extent(sequence), extents[i]);
+
+            std::vector<gloperate_text::LineMetrics> lines;
+            gloperate_text::Typesetter::measureLines(sequence, lines);
+            ASSERT_EQ(lines.size(), lineWidths[i].size());
+            for (size_t l = 0; l < lines.size(); ++l)
+                EXPECT_EQ(lines[l].width * (14.f / m_fontFace.size()), lineWidths[i][l]);
+        }
+    }
+}
+
+TEST_F(Typesetter_test, PrefixQueriesMatchExtent)
+{
+    std::mt19937 random(4);
+    for (auto s = 0; s < 100; ++s)
+    {
+        std::u32string string;
+        const auto length = random() % 40;
+        for (auto i = 0u; i < length; ++i)
+            string += random() % 6 == 0 ? U' ' : static_cast<char32_t>(33 + random() % 94);
+
+        gloperate_text::GlyphSequence sequence;
+        sequence.setString(string);
+        sequence.setFontFace(&m_fontFace);
+        sequence.setFontSize(14.f);
+
+        for (size_t k = 0; k <= string.size(); ++k)
+        {
+            if (k > 0 && string[k - 1] == U' ')
+                continue;
+
+            gloperate_text::GlyphSequence prefix;
+            prefix.setString(string.substr(0, k));
+            prefix.setFontFace(&m_fontFace);
+            prefix.setFontSize(14.f);
+
+            const auto width = gloperate_text::Typesetter::width(sequence, 0, k);
+            EXPECT_FLOAT_EQ(gloperate_text::Typesetter::extent(prefix).x, width);
+            EXPECT_EQ(k, gloperate_text::Typesetter::indexAt(sequence, width));
+        }
+
+        const auto width = static_cast<float>(random() % 200);
+        const auto fitting = gloperate_text::Typesetter::fittingPrefix(sequence, width);
+        EXPECT_LE(gloperate_text::Typesetter::width(sequence, 0, fitting), width * 1.0001f);
+        if (fitting < string.size())
+        {
+            EXPECT_GT(gloperate_text::Typesetter::width(sequence, 0, fitting + 1), width * 0.9999f);
+        }
+    }
+}
+
+TEST_F(Typesetter_test, TruncationMatchesTypeset)
+{
+    const auto ellipsis = std::u32string(U"...");
+
+    // varying advances, and fixed pitch of a pitch whose multiples are rounded
+    gloperate_text::FontFace fixedPitch;
+    setupFixedPitchTestFontFace(fixedPitch, 7.3f, false);
+    auto fontFace = &m_fontFace;
+
+    const auto createSequence = [&](const std::u32string & string)
+    {
+        gloperate_text::GlyphSequence sequence;
+        sequence.setString(string);
+        sequence.setFontFace(fontFace);
+        sequence.setFontSize(fontFace->size());
+        sequence.setAlignment(gloperate_text::Alignment::Centered);
+        sequence.setLineAnchor(gloperate_text::LineAnchor::Center);
+        return sequence;
+    };
+
+    std::mt19937 random(5);
+    for (auto s = 0; s < 200; ++s)
+    {
+        fontFace = s < 100 ? &m_fontFace : &fixedPitch;
+
+        std::u32string string;
+        const auto length = 1 + random() % 40;
+        for (auto i = 0u; i < length; ++i)
+            string += random() % 6 == 0 ? U' ' : static_cast<char32_t>(33 + random() % 94);
+
+        const auto sequence = createSequence(string);
+        const auto width = static_cast<float>(random() % 300);
+
+        // the longest prefix, ending with a depictable glyph, that fits with the ellipsis
+        auto expectedString = string;
+        if (gloperate_text::Typesetter::extent(sequence).x > width)
+        {
+            expectedString = ellipsis;
+            for (size_t k = 1; k <= string.size(); ++k)
+            {
+                const auto candidate = string.substr(0, k) + ellipsis;
+                if (string[k - 1] != U' ' && gloperate_text::Typesetter::extent(createSequence(candidate)).x <= width)
+                    expectedString = candidate;
+            }
+        }
+
+        const auto expectedSequence = createSequence(expectedString);
+        gloperate_text::GlyphVertexCloud::Vertices expected(expectedSequence.depictableSize());
+        const auto expectedExtent = gloperate_text::Typesetter::typeset(expectedSequence, expected.data());
+
+        gloperate_text::GlyphVertexCloud::Vertices vertices(sequence.depictableSize() + ellipsis.size());
+        auto vertexCount = size_t(0);
+        const auto extent = gloperate_text::Typesetter::typesetTruncated(sequence, width, vertices.data(), vertexCount, ellipsis);
+
+        EXPECT_EQ(expectedExtent, extent);
+        ASSERT_EQ(expected.size(), vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            EXPECT_EQ(expected[i].origin, vertices[i].origin);
+            EXPECT_EQ(expected[i].vtan, vertices[i].vtan);
+            EXPECT_EQ(expected[i].uvRect, vertices[i].uvRect);
+        }
+    }
+}
+
+TEST_F(Typesetter_test, FittedFontSizeIsLargestFitting)
+{
+    std::mt19937 random(6);
+    for (auto s = 0; s < 200; ++s)
+    {
+        // words separated by single spaces
+        std::u32string string(1, U'a');
+        const auto length = random() % 120;
+        for (auto i = 0u; i < length; ++i)
+            string += random() % 6 == 0 && string.back() != U' ' ? U' ' : static_cast<char32_t>(97 + random() % 26);
+        if (string.back() == U' ')
+            string.pop_back();
+
+        const auto box = glm::vec2(20.f + static_cast<float>(random() % 300), 10.f + static_cast<float>(random() % 200));
+
+        gloperate_text::GlyphSequence sequence;
+        sequence.setString(string);
+        sequence.setFontFace(&m_fontFace);
+        sequence.setFontSize(12.f);
+        sequence.setWordWrap(s % 4 != 0);
+        sequence.setLineWidth(box.x);
+
+        const auto fontSize = gloperate_text::Typesetter::fitFontSize(sequence, box);
+        EXPECT_EQ(fontSize, sequence.fontSize());
+
+        const auto extent = gloperate_text::Typesetter::extent(sequence);
+        EXPECT_LE(extent.x, box.x);
+        EXPECT_LE(extent.y, box.y);
+
+        // increasing font sizes fit up to the fitted one
+        auto larger = fontSize * 0.5f;
+        do
+        {
+            larger *= 1.01f;
+            sequence.setFontSize(larger);
+        } while (gloperate_text::Typesetter::extent(sequence).x <= box.x && gloperate_text::Typesetter::extent(sequence).y <= box.y);
+
+        EXPECT_GE(fontSize * 1.002f, larger / 1.01f);
+    }
+}
+
+TEST_F(Typesetter_test, FittedWrappedFontSizeIsExact)
+{
+    std::mt19937 random(7);
+    for (auto s = 0; s < 200; ++s)
+    {
+        std::u32string string(1, U'a');
+        const auto length = random() % 120;
+        for (auto i = 0u; i < length; ++i)
+            string += random() % 5 == 0 && string.back() != U' ' ? U' ' : static_cast<char32_t>(97 + random() % 26);
+
+        const auto box = glm::vec2(20.f + static_cast<float>(random() % 300), 10.f + static_cast<float>(random() % 200));
+
+        gloperate_text::GlyphSequence sequence;
+        sequence.setString(string);
+        sequence.setFontFace(&m_fontFace);
+        sequence.setFontSize(12.f);
+        sequence.setWordWrap(true);
+        sequence.setLineWidth(box.x * static_cast<float>(1 + random() % 3) * 0.5f);
+
+        const auto fits = [&]()
+        {
+            const auto extent = gloperate_text::Typesetter::extent(sequence);
+            return extent.x <= box.x && extent.y <= box.y;
+        };
+
+        const auto fontSize = gloperate_text::Typesetter::fitFontSize(sequence, box);
+        EXPECT_TRUE(fits());
+
+        sequence.setFontSize(fontSize * (1.f + 1e-4f));
+        EXPECT_FALSE(fits());
+    }
+}